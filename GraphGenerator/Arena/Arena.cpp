@@ -0,0 +1,162 @@
+#include "Arena.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace arena;
+
+#define CHUNK_SIZE (256 * 1024)
+
+namespace {
+
+	struct KindStats {
+		std::atomic<size_t> objects{ 0 };
+		std::atomic<size_t> bytes{ 0 };
+	};
+
+	struct Finalizer {
+		void* object;
+		void (*destroy)(void*);
+	};
+
+	struct Session {
+		std::mutex mutex;
+		std::vector<void*> chunks;
+		std::vector<std::unique_ptr<std::vector<Finalizer>>> finalizers;	// one list per thread
+		std::atomic<size_t> reserved{ 0 };
+		std::atomic<unsigned> generation{ 0 };				// bumped by Release, invalidates the threads' chunks
+		KindStats stats[(unsigned)Kind::Count];
+	};
+
+	// The current chunk of a thread
+	struct Cursor {
+		char* next = nullptr;
+		char* end = nullptr;
+		std::vector<Finalizer>* finalizers = nullptr;
+		unsigned generation = 0;
+	};
+
+	Session& GetSession() {
+		static Session session;
+		return session;
+	}
+
+	thread_local Cursor cursor;
+
+	// The chunks and finalizers of the threads are dropped by Release (a new generation)
+	void SyncGeneration(Session& session) {
+		unsigned generation = session.generation.load(std::memory_order_acquire);
+		if (cursor.generation != generation) {
+			cursor = Cursor();
+			cursor.generation = generation;
+		}
+	}
+
+	void* NewChunk(Session& session, size_t size) {
+		void* chunk = std::malloc(size);
+		if (!chunk)
+			throw std::bad_alloc();
+		std::lock_guard<std::mutex> lock(session.mutex);
+		session.chunks.push_back(chunk);
+		session.reserved += size;
+		return chunk;
+	}
+}
+
+void* arena::Allocate(size_t size, size_t alignment, Kind kind) {
+	auto& session = GetSession();
+	auto& stats = session.stats[(unsigned)kind];
+	stats.objects.fetch_add(1, std::memory_order_relaxed);
+	stats.bytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (size + alignment > CHUNK_SIZE / 4)						// large objects get their own chunk
+		return NewChunk(session, size);
+
+	SyncGeneration(session);
+	auto aligned = [alignment](char* ptr) { return (char*)(((uintptr_t)ptr + alignment - 1) & ~(uintptr_t)(alignment - 1)); };
+	char* ptr = cursor.next ? aligned(cursor.next) : nullptr;
+	if (!ptr || ptr + size > cursor.end) {
+		cursor.next = (char*)NewChunk(session, CHUNK_SIZE);
+		cursor.end = cursor.next + CHUNK_SIZE;
+		ptr = aligned(cursor.next);
+	}
+	cursor.next = ptr + size;
+	return ptr;
+}
+
+void arena::AddFinalizer(void* object, void (*destroy)(void*)) {
+	auto& session = GetSession();
+	SyncGeneration(session);
+	if (!cursor.finalizers) {
+		std::lock_guard<std::mutex> lock(session.mutex);
+		session.finalizers.push_back(std::make_unique<std::vector<Finalizer>>());
+		cursor.finalizers = session.finalizers.back().get();
+	}
+	cursor.finalizers->push_back({ object, destroy });
+}
+
+/*
+	O(objects): one call per object with a destructor (in the reverse order of their allocation per thread),
+	then one free per chunk.
+	Must not run concurrently with Allocate.
+*/
+void arena::Release() {
+	auto& session = GetSession();
+	std::lock_guard<std::mutex> lock(session.mutex);
+	for (auto& finalizers : session.finalizers) {
+		for (auto it = finalizers->rbegin(); it != finalizers->rend(); ++it)
+			it->destroy(it->object);
+	}
+	session.finalizers.clear();
+	for (auto* chunk : session.chunks)
+		std::free(chunk);
+	session.chunks.clear();
+	session.reserved = 0;
+	for (auto& stats : session.stats) {
+		stats.objects = 0;
+		stats.bytes = 0;
+	}
+	session.generation++;
+}
+
+Stats arena::GetStats(Kind kind) {
+	auto& stats = GetSession().stats[(unsigned)kind];
+	Stats result;
+	result.objects = stats.objects.load(std::memory_order_relaxed);
+	result.bytes = stats.bytes.load(std::memory_order_relaxed);
+	return result;
+}
+
+size_t arena::GetReservedBytes() {
+	return GetSession().reserved.load(std::memory_order_relaxed);
+}
+
+const char* arena::GetKindName(Kind kind) {
+	switch (kind) {
+		case Kind::Symbol: return "Symbol";
+		case Kind::Structure: return "Structure";
+		case Kind::Method: return "Method";
+		case Kind::Definition: return "Definition";
+		case Kind::Node: return "Node";
+		case Kind::Edge: return "Edge";
+		default: 
+			assert(0);
+			return "";
+	}
+}
+
+void arena::PrintStats(std::ostream& out) {
+	size_t totalBytes = 0;
+	out << "Arena (object kind: objects, bytes)\n";
+	for (unsigned kind = 0; kind < (unsigned)Kind::Count; ++kind) {
+		auto stats = GetStats((Kind)kind);
+		totalBytes += stats.bytes;
+		out << "\t" << GetKindName((Kind)kind) << ": " << stats.objects << ", " << stats.bytes << "\n";
+	}
+	out << "\tTotal: " << totalBytes << " bytes used, " << GetReservedBytes() << " bytes reserved\n";
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <utility>
+#include <type_traits>
+
+/*
+	Bump allocator for the objects of a mining session (symbols of the SymbolTables, graph nodes and edges).
+	These objects are never freed one by one: they live until the end of the session and are all released 
+	by Release, which runs the destructors of the objects that have one (O(objects): the symbols and nodes own
+	strings and tables) and then frees the chunks.
+	It is not faster than the heap for these objects (MicroBenchmark: arena::New / arena::Release vs new / delete
+	Definition), it counts the objects and bytes per kind (--arena-stats) and ends a session in one call.
+	Every thread bumps its own chunk, so the mining workers do not contend on allocation.
+*/
+
+namespace arena {
+
+	enum class Kind : unsigned {
+		Symbol,
+		Structure,
+		Method,
+		Definition,
+		Node,
+		Edge,
+		Count
+	};
+
+	struct Stats {
+		size_t objects = 0;
+		size_t bytes = 0;			// sizeof the objects, not what their own containers allocate
+	};
+
+	void* Allocate(size_t size, size_t alignment, Kind kind);
+
+	// destroy(object) runs at Release
+	void AddFinalizer(void* object, void (*destroy)(void*));
+
+	template<typename T, typename ...Args> T* New(Kind kind, Args&&... args) {
+		T* object = new (Allocate(sizeof(T), alignof(T), kind)) T(std::forward<Args>(args)...);
+		if constexpr (!std::is_trivially_destructible_v<T>)
+			AddFinalizer(object, [](void* object) { ((T*)object)->~T(); });
+		return object;
+	}
+
+	// Destroys and frees everything allocated so far, all the pointers handed out become invalid
+	void Release();
+
+	Stats GetStats(Kind kind);
+	size_t GetReservedBytes();
+	void PrintStats(std::ostream& out = std::cout);
+	const char* GetKindName(Kind kind);
+}
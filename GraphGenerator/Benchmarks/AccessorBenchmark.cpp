@@ -0,0 +1,145 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "SymbolTable.h"
+#include "STSerialization.h"
+#include "GraphGeneration.h"
+
+/*
+	Heap allocations made by the SymbolTable consumers (member table accessors, graph generation,
+	ST json, ST serialization) over a synthetic SymbolTable.
+	The member tables are returned by const reference: walking every table of every structure and
+	method must not allocate. The "by value" row copies the same tables, as the accessors used to.
+
+	argv[1]: (optional) structures (default: 1000)
+	argv[2]: (optional) methods per structure (default: 10)
+*/
+
+using namespace dependenciesMining;
+
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+static void BuildTable(SymbolTable& st, unsigned structureCount, unsigned methodCount) {
+	std::vector<Structure*> structures;
+	for (unsigned i = 0; i < structureCount; ++i) {
+		std::string name = "ns::Class" + std::to_string(i);
+		Structure structure(InternID(name), name, "ns::", StructureType::Class, "file" + std::to_string(i % 50) + ".h", i, 1);
+		structures.push_back((Structure*)st.Install(structure.GetID(), structure));
+	}
+	for (unsigned i = 0; i < structureCount; ++i) {
+		auto* structure = structures[i];
+		auto* other = structures[(i + 1) % structureCount];
+		if (i)
+			structure->InstallBase(structures[i - 1]->GetID(), structures[i - 1]);
+		if (i % 2)												// friends are written to json as whole structures, no friend chains
+			structure->InstallFriend(structures[i - 1]->GetID(), structures[i - 1]);
+		for (unsigned j = 0; j < 4; ++j) {
+			std::string name = structure->GetName() + "::field" + std::to_string(j);
+			Definition field(InternID(name), name, "ns::", other, structure->GetSourceInfo().GetFileName(), i, j);
+			field.SetFullType(other->GetName());
+			structure->InstallField(field.GetID(), field);
+		}
+		for (unsigned j = 0; j < methodCount; ++j) {
+			std::string name = structure->GetName() + "::method" + std::to_string(j) + "()";
+			Method method(InternID(name), name, "ns::", structure->GetSourceInfo().GetFileName(), i, j);
+			method.SetMethodType(MethodType::UserMethod);
+			method.SetReturnType(other);
+			for (unsigned k = 0; k < 2; ++k) {
+				std::string argName = name + "::arg" + std::to_string(k);
+				Definition arg(InternID(argName), argName, "ns::", other, structure->GetSourceInfo().GetFileName(), i, k);
+				method.InstallArg(arg.GetID(), arg);
+				std::string defName = name + "::var" + std::to_string(k);
+				Definition def(InternID(defName), defName, "ns::", other, structure->GetSourceInfo().GetFileName(), i, k);
+				method.InstallDefinition(def.GetID(), def);
+			}
+			SourceInfo locEnd(structure->GetSourceInfo().GetFileName(), i, 20);
+			Method::MemberExpr expr("arg0.field0", locEnd, structure->GetSourceInfo().GetFileName(), i, 10);
+			method.InsertMemberExpr(expr, Method::Member("field0", other, locEnd, ClassField_mem_t), locEnd.GetFileName() + ":" + std::to_string(i) + ":10");
+			structure->InstallMethod(method.GetID(), method);
+		}
+	}
+}
+
+static size_t WalkByReference(const SymbolTable& st) {
+	size_t count = 0;
+	for (const auto& it : st) {
+		auto* structure = (Structure*)it.second;
+		for (const auto* table : { &structure->GetBases(), &structure->GetFriends(), &structure->GetContains(), &structure->GetFields(), &structure->GetTemplateArguments() })
+			count += std::distance(table->begin(), table->end());
+		for (const auto& m : structure->GetMethods()) {
+			auto* method = (Method*)m.second;
+			count += std::distance(method->GetArguments().begin(), method->GetArguments().end());
+			count += std::distance(method->GetDefinitions().begin(), method->GetDefinitions().end());
+			for (const auto& expr : method->GetMemberExpr())
+				count += expr.second.GetMembers().size();
+		}
+	}
+	return count;
+}
+
+static size_t WalkByValue(const SymbolTable& st) {
+	size_t count = 0;
+	for (const auto& it : st) {
+		auto* structure = (Structure*)it.second;
+		for (SymbolTable table : { structure->GetBases(), structure->GetFriends(), structure->GetContains(), structure->GetFields(), structure->GetTemplateArguments() })
+			count += std::distance(table.begin(), table.end());
+		SymbolTable methods = structure->GetMethods();
+		for (const auto& m : methods) {
+			auto* method = (Method*)m.second;
+			SymbolTable args = method->GetArguments();
+			SymbolTable defs = method->GetDefinitions();
+			count += std::distance(args.begin(), args.end());
+			count += std::distance(defs.begin(), defs.end());
+			std::map<std::string, Method::MemberExpr> memberExprs = method->GetMemberExpr();
+			for (const auto& expr : memberExprs) {
+				std::vector<Method::Member> members = expr.second.GetMembers();
+				count += members.size();
+			}
+		}
+	}
+	return count;
+}
+
+template<typename F> static void Report(const char* name, F&& f) {
+	size_t before = allocations.load();
+	f();
+	std::cout << std::left << std::setw(32) << name << allocations.load() - before << "\n";
+}
+
+int main(int argc, const char** argv) {
+	unsigned structureCount = (argc >= 2) ? std::max(1, std::stoi(argv[1])) : 1000;
+	unsigned methodCount = (argc >= 3) ? std::max(0, std::stoi(argv[2])) : 10;
+
+	SymbolTable st;
+	BuildTable(st, structureCount, methodCount);
+	std::cout << structureCount << " structures, " << methodCount << " methods per structure\n\n";
+	std::cout << std::left << std::setw(32) << "pass" << "heap allocations\n";
+
+	size_t count = 0;
+	Report("member tables (by reference)", [&] { count = WalkByReference(st); });
+	Report("member tables (by value)", [&] { count -= WalkByValue(st); });
+	Report("graph generation", [&] { graphGeneration::GenetareDependenciesGraph(st); });
+	Report("ST json", [&] { Json::Value json; st.AddJsonSymbolTable(json); });
+	Report("ST serialization", [&] { std::ostringstream out; WriteSymbolTable(out, st); });
+	return count == 0 ? 0 : 1;
+}
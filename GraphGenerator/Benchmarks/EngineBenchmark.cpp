@@ -0,0 +1,83 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include "SourceLoader.h"
+#include "DependenciesMining.h"
+#include "json/writer.h"
+
+/*
+	Matchers vs SinglePass mining engine, per TU.
+	Every TU is mined (repetitions) times by each engine into a fresh SymbolTable, the fastest run is reported.
+	Also checks whether both engines produce the same SymbolTable ("same ST" column).
+
+	argv[1]: (optional) directory with sources (default: GraphGenerator/Testfiles)
+	argv[2]: (optional) repetitions (default: 5)
+	argv[3]: (optional) path/to/ignoredFilePaths
+*/
+
+using namespace dependenciesMining;
+
+struct EngineRun {
+	double ms = 0;
+	Json::Value st;
+};
+
+static EngineRun Mine(const CompilationDatabase& cmpDB, const std::string& file, MiningEngine engine, unsigned repetitions) {
+	EngineRun run;
+	for (unsigned i = 0; i < repetitions; ++i) {
+		SymbolTable table;
+		ClangTool tool(cmpDB, { file });
+		MiningOptions options;
+		options.engine = engine;
+		auto actionFactory = NewMiningActionFactory(options, table);
+
+		auto start = std::chrono::steady_clock::now();
+		tool.run(actionFactory.get());
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+		if (i == 0 || elapsed.count() < run.ms)
+			run.ms = elapsed.count();
+		if (i == 0)
+			table.AddJsonSymbolTable(run.st);
+	}
+	return run;
+}
+
+int main(int argc, const char** argv) {
+	std::string fullPath = std::string(__FILE__);
+	std::size_t found = fullPath.find_last_of("/\\");
+	std::string srcDir = (argc >= 2) ? argv[1] : fullPath.substr(0, found + 1) + "../Testfiles";
+	unsigned repetitions = (argc >= 3) ? std::max(1, std::stoi(argv[2])) : 5;
+	std::string ignoredFilePaths = (argc >= 4) ? argv[3] : "";
+
+	ignored["filePaths"] = new IgnoredFilePaths(ignoredFilePaths);
+	ignored["namespaces"] = new IgnoredNamespaces();
+
+	sourceLoader::SourceLoader srcLoader(srcDir);
+	srcLoader.LoadSources();
+	auto srcs = srcLoader.GetSources();
+	std::sort(srcs.begin(), srcs.end());
+	FixedCompilationDatabase cmpDB(".", std::vector<std::string>());
+
+	double totalMatchers = 0, totalSinglePass = 0;
+	std::cout << std::left << std::setw(40) << "TU" << std::right << std::setw(14) << "matchers ms" << std::setw(16) << "single-pass ms" << std::setw(10) << "saved" << "  same ST\n";
+	for (const auto& src : srcs) {
+		auto matchers = Mine(cmpDB, src, MiningEngine::Matchers, repetitions);
+		auto singlePass = Mine(cmpDB, src, MiningEngine::SinglePass, repetitions);
+		totalMatchers += matchers.ms;
+		totalSinglePass += singlePass.ms;
+
+		std::string name = src.substr(src.find_last_of("/\\") + 1);
+		double saved = matchers.ms > 0 ? 100 * (matchers.ms - singlePass.ms) / matchers.ms : 0;
+		std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(14) << matchers.ms << std::setw(16) << singlePass.ms << std::setw(9) << saved << "%"
+			<< "  " << (matchers.st == singlePass.st ? "yes" : "NO") << "\n";
+	}
+	double saved = totalMatchers > 0 ? 100 * (totalMatchers - totalSinglePass) / totalMatchers : 0;
+	std::cout << std::left << std::setw(40) << "total" << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(14) << totalMatchers << std::setw(16) << totalSinglePass << std::setw(9) << saved << "%\n";
+	return 0;
+}
@@ -0,0 +1,98 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
+#include "DependenciesMining.h"
+#include "clang/Frontend/ASTUnit.h"
+
+/*
+	Cost of the ignored file check per declaration, on a TU that includes the STL.
+	The locations of all the declarations of the TU are collected first, then every location is checked
+	(repetitions) times: by path (ignored["filePaths"] on the presumed file name, as every decl did before)
+	and by FileID (IgnoredFileIDs, each file classified once per TU).
+
+	argv[1]: (optional) path/to/ignoredFilePaths
+	argv[2]: (optional) repetitions (default: 5)
+*/
+
+using namespace dependenciesMining;
+using Clock = std::chrono::steady_clock;
+
+static const char* stlCode =
+	"#include <vector>\n"
+	"#include <map>\n"
+	"#include <unordered_map>\n"
+	"#include <string>\n"
+	"#include <memory>\n"
+	"#include <algorithm>\n"
+	"#include <iostream>\n"
+	"#include <functional>\n"
+	"class Widget { std::vector<std::string> names; std::map<int, Widget*> children; };\n";
+
+class LocationsCollector : public RecursiveASTVisitor<LocationsCollector> {
+	SourceManager& sm;
+public:
+	std::vector<PresumedLoc> locations;
+
+	LocationsCollector(SourceManager& sm) : sm(sm) {};
+	bool VisitDecl(Decl* d) {
+		auto loc = sm.getPresumedLoc(d->getLocation());
+		if (loc.isValid())
+			locations.push_back(loc);
+		return true;
+	}
+};
+
+static double Ms(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, const char** argv) {
+	std::string ignoredFilePaths = (argc >= 2) ? argv[1] : "";
+	unsigned repetitions = (argc >= 3) ? std::max(1, std::stoi(argv[2])) : 5;
+
+	ignored["filePaths"] = new IgnoredFilePaths(ignoredFilePaths);
+	ignored["namespaces"] = new IgnoredNamespaces();
+
+	auto ast = buildASTFromCodeWithArgs(stlCode, { "-std=c++17" }, "stl.cpp");
+	if (!ast) {
+		std::cout << "Could not parse the STL TU\n";
+		return 1;
+	}
+	LocationsCollector collector(ast->getSourceManager());
+	collector.TraverseDecl(ast->getASTContext().getTranslationUnitDecl());
+	const auto& locations = collector.locations;
+
+	std::unordered_set<unsigned> files;
+	for (const auto& loc : locations)
+		files.insert(loc.getFileID().getHashValue());
+
+	double byPathMs = 0, byFileIDMs = 0;
+	size_t byPathIgnored = 0, byFileIDIgnored = 0;
+	for (unsigned r = 0; r < repetitions; ++r) {
+		auto start = Clock::now();
+		byPathIgnored = 0;
+		for (const auto& loc : locations)
+			byPathIgnored += ignored.at("filePaths")->isIgnored(loc.getFilename());
+		double ms = Ms(start);
+		byPathMs = r ? std::min(byPathMs, ms) : ms;
+
+		start = Clock::now();
+		IgnoredFileIDs ignoredFiles;
+		byFileIDIgnored = 0;
+		for (const auto& loc : locations)
+			byFileIDIgnored += ignoredFiles.IsIgnored(loc);
+		ms = Ms(start);
+		byFileIDMs = r ? std::min(byFileIDMs, ms) : ms;
+	}
+
+	std::cout << locations.size() << " decls in " << files.size() << " files\n";
+	std::cout << std::left << std::setw(12) << "check" << std::right << std::setw(12) << "total ms" << std::setw(14) << "ns per decl" << std::setw(10) << "ignored\n";
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << std::left << std::setw(12) << "by path" << std::right << std::setw(12) << byPathMs << std::setw(14) << 1e6 * byPathMs / std::max<size_t>(1, locations.size()) << std::setw(9) << byPathIgnored << "\n";
+	std::cout << std::left << std::setw(12) << "by FileID" << std::right << std::setw(12) << byFileIDMs << std::setw(14) << 1e6 * byFileIDMs / std::max<size_t>(1, locations.size()) << std::setw(9) << byFileIDIgnored << "\n";
+	return byPathIgnored == byFileIDIgnored ? 0 : 1;
+}
@@ -0,0 +1,444 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <memory>
+#include <algorithm>
+#include "SymbolTable.h"
+#include "Graph.h"
+#include "Ignored.h"
+#include "Arena.h"
+#include "uobject_untyped.h"
+#include "json/reader.h"
+#include "json/writer.h"
+
+/*
+	The core data structures in isolation: ns and heap allocations per operation of the SymbolTable, Structure and Method
+	installs, Node::AddEdge, IgnoredFilePaths::isIgnored, the namespace name building of the mining and untyped::Object.
+	Also the arena against the heap: allocating a Definition and tearing it down (arena::Release vs delete).
+	Every case is run (repetitions) times on fresh data, the fastest run is reported (the allocations of the last run).
+	With --baseline the results are compared to a file saved by --save-baseline: a case slower than the baseline by more
+	than the tolerance, or allocating more per operation, fails the run (exit code 1).
+
+	--scale N: operations per case (default: 20000)
+	--repetitions N: (default: 5)
+	--save-baseline PATH, --baseline PATH, --tolerance PERCENT (default: 25)
+*/
+
+using namespace dependenciesMining;
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+static volatile size_t sink = 0;						// keeps the results of the operations alive
+
+struct Result {
+	std::string name;
+	double nsPerOp = 0;
+	double allocationsPerOp = 0;
+};
+
+class Harness {
+private:
+	unsigned repetitions;
+	std::vector<Result> results;
+public:
+	Harness(unsigned repetitions) : repetitions(repetitions) {}
+
+	/*
+		setup() makes the data of a run (not timed), run(data) does ops operations on it.
+		The arena is released after every run: what the operations allocated there is dropped with the data.
+	*/
+	template<typename Setup, typename Run> void Measure(const std::string& name, size_t ops, const Setup& setup, const Run& run) {
+		Result result;
+		result.name = name;
+		for (unsigned r = 0; r < repetitions; ++r) {
+			{
+				auto data = setup();
+				size_t before = allocations.load();
+				auto start = Clock::now();
+				run(*data);
+				double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+				result.allocationsPerOp = (double)(allocations.load() - before) / ops;
+				result.nsPerOp = r ? std::min(result.nsPerOp, ns / ops) : ns / ops;
+			}
+			arena::Release();
+		}
+		results.push_back(result);
+	}
+
+	const std::vector<Result>& GetResults() const { return results; }
+};
+
+// ----------------------------------------------------------------------------------------
+
+// Fully qualified names of template specializations, as the mining produces them
+static std::string TemplateName(unsigned i) {
+	return "ns::detail::Map<ns::Key" + std::to_string(i) + ", std::vector<ns::Value" + std::to_string(i % 97) + ", std::allocator<ns::Value" + std::to_string(i % 97) + ">>>";
+}
+
+static void SymbolTableCases(Harness& harness, unsigned scale) {
+	struct Structures {
+		SymbolTable table;
+		std::vector<Structure> structures;
+	};
+	auto structures = [scale]() {
+		auto data = std::make_unique<Structures>();
+		for (unsigned i = 0; i < scale; ++i) {
+			std::string name = TemplateName(i);
+			data->structures.emplace_back(InternID(name), name, "ns::detail::", StructureType::TemplateInstantiationSpecialization, "map.h", i, 1);
+		}
+		return data;
+	};
+	harness.Measure("SymbolTable::Install", scale, structures, [](Structures& data) {
+		for (const auto& structure : data.structures)
+			data.table.Install(structure.GetID(), structure);
+		});
+	harness.Measure("SymbolTable::Lookup", scale, [&structures]() {
+		auto data = structures();
+		for (const auto& structure : data->structures)
+			data->table.Install(structure.GetID(), structure);
+		return data;
+		}, [](Structures& data) {
+			size_t found = 0;
+			for (const auto& structure : data.structures)
+				found += data.table.Lookup(structure.GetID()) != nullptr;
+			sink = sink + found;
+		});
+}
+
+static void StructureCases(Harness& harness, unsigned scale) {
+	constexpr unsigned membersPerStructure = 10;
+	unsigned structureCount = std::max(1u, scale / membersPerStructure);
+	struct Members {
+		std::vector<Structure> structures;
+		std::vector<Method> methods;
+		std::vector<Definition> fields;
+	};
+	auto members = [=]() {
+		auto data = std::make_unique<Members>();
+		for (unsigned i = 0; i < structureCount; ++i) {
+			std::string name = "ns::Class" + std::to_string(i);
+			data->structures.emplace_back(InternID(name), name, "ns::", StructureType::Class, "class.h", i, 1);
+			for (unsigned j = 0; j < membersPerStructure; ++j) {
+				std::string methodName = name + "::method" + std::to_string(j) + "(const ns::Key" + std::to_string(j) + " &, int)";
+				data->methods.emplace_back(InternID(methodName), methodName, "ns::", "class.h", i, j);
+				std::string fieldName = name + "::field" + std::to_string(j);
+				data->fields.emplace_back(InternID(fieldName), fieldName, "ns::", nullptr, "class.h", i, j);
+			}
+		}
+		return data;
+	};
+	size_t ops = (size_t)structureCount * membersPerStructure;
+	harness.Measure("Structure::InstallMethod", ops, members, [](Members& data) {
+		for (size_t i = 0; i < data.methods.size(); ++i)
+			data.structures[i / membersPerStructure].InstallMethod(data.methods[i].GetID(), data.methods[i]);
+		});
+	harness.Measure("Structure::InstallField", ops, members, [](Members& data) {
+		for (size_t i = 0; i < data.fields.size(); ++i)
+			data.structures[i / membersPerStructure].InstallField(data.fields[i].GetID(), data.fields[i]);
+		});
+}
+
+static void MemberExprCases(Harness& harness, unsigned scale) {
+	struct MemberExprs {
+		Method method;
+		std::vector<Method::MemberExpr> exprs;
+		std::vector<Method::Member> members;
+		std::vector<std::string> locations;
+	};
+	// Chains (a.b.c) insert a member per link at the location of the chain: two members per location
+	harness.Measure("Method::InsertMemberExpr", scale, [scale]() {
+		auto data = std::make_unique<MemberExprs>();
+		for (unsigned i = 0; i < scale; ++i) {
+			unsigned line = i / 2;
+			data->exprs.emplace_back("other->link->f" + std::to_string(i % 4), SourceInfo("method.cpp", line, 20 + (int)(i % 2) * 6), "method.cpp", line, 5);
+			data->members.emplace_back(i % 2 ? "f" + std::to_string(i % 4) : "link", nullptr, SourceInfo("method.cpp", line, 20 + (int)(i % 2) * 6), ClassField_mem_t);
+			data->locations.push_back("method.cpp:" + std::to_string(line) + ":5");
+		}
+		return data;
+		}, [](MemberExprs& data) {
+			for (size_t i = 0; i < data.exprs.size(); ++i)
+				data.method.InsertMemberExpr(data.exprs[i], data.members[i], data.locations[i]);
+		});
+}
+
+static void GraphCases(Harness& harness, unsigned scale) {
+	unsigned nodeCount = std::max(2u, scale / 8);
+	struct Nodes {
+		std::vector<std::unique_ptr<graph::Node>> nodes;
+	};
+	// Every pair of nodes gets several dependencies: the edge is found and updated after the first
+	harness.Measure("Node::AddEdge", scale, [nodeCount]() {
+		auto data = std::make_unique<Nodes>();
+		for (unsigned i = 0; i < nodeCount; ++i) {
+			data->nodes.push_back(std::make_unique<graph::Node>());
+			data->nodes.back()->GetData().id = InternID("ns::Class" + std::to_string(i));
+		}
+		return data;
+		}, [scale, nodeCount](Nodes& data) {
+			for (unsigned i = 0; i < scale; ++i) {
+				auto* from = data.nodes[i % nodeCount].get();
+				auto* to = data.nodes[(i / nodeCount * 7 + i + 1) % nodeCount].get();
+				from->AddEdge(to, (graph::Edge::DependencyType)(i % graph::DependencyTypesCount));
+			}
+		});
+}
+
+// A field as the mining installs it: its strings are heap allocated either way
+static Definition* NewDefinition(unsigned i, bool arenaAllocated) {
+	std::string name = "ns::detail::Class" + std::to_string(i / 10) + "::field" + std::to_string(i % 10);
+	if (arenaAllocated)
+		return arena::New<Definition>(arena::Kind::Definition, InternID(name), name, "ns::detail::", nullptr, "include/ns/detail/class.h", i, 1);
+	return new Definition(InternID(name), name, "ns::detail::", nullptr, "include/ns/detail/class.h", i, 1);
+}
+
+static void ArenaCases(Harness& harness, unsigned scale) {
+	struct Definitions {
+		std::vector<Definition*> definitions;
+		bool heap = false;
+		~Definitions() {
+			if (heap) {
+				for (auto* definition : definitions)
+					delete definition;
+			}
+		}
+	};
+	auto none = []() { return std::make_unique<Definitions>(); };
+	auto allocated = [scale](bool arenaAllocated) {
+		auto data = std::make_unique<Definitions>();
+		data->heap = !arenaAllocated;
+		for (unsigned i = 0; i < scale; ++i)
+			data->definitions.push_back(NewDefinition(i, arenaAllocated));
+		return data;
+	};
+	harness.Measure("arena::New Definition", scale, none, [scale](Definitions& data) {
+		for (unsigned i = 0; i < scale; ++i)
+			data.definitions.push_back(NewDefinition(i, true));
+		});
+	harness.Measure("new Definition", scale, none, [scale](Definitions& data) {
+		data.heap = true;
+		for (unsigned i = 0; i < scale; ++i)
+			data.definitions.push_back(NewDefinition(i, false));
+		});
+	harness.Measure("arena::Release Definition", scale, [&allocated]() { return allocated(true); }, [](Definitions& data) {
+		arena::Release();
+		data.definitions.clear();
+		});
+	harness.Measure("delete Definition", scale, [&allocated]() { return allocated(false); }, [](Definitions& data) {
+		for (auto* definition : data.definitions)
+			delete definition;
+		data.definitions.clear();
+		});
+}
+
+static void IgnoredCases(Harness& harness, unsigned scale) {
+	static const char* directories[] = {
+		"C:/Program Files (x86)/Microsoft Visual Studio/2019/Community/VC/Tools/MSVC/14.29.30133/include/",
+		"C:/Program Files (x86)/Windows Kits/10/Include/10.0.19041.0/ucrt/",
+		"/usr/include/c++/12/bits/",
+		"C:/Users/user/source/repos/project/src/module/",
+		"/home/user/project/src/module/detail/"
+	};
+	struct Paths {
+		IgnoredFilePaths ignoredFilePaths;
+		std::vector<std::string> paths;
+	};
+	harness.Measure("IgnoredFilePaths::isIgnored", scale, [scale]() {
+		auto data = std::make_unique<Paths>();
+		data->ignoredFilePaths.Insert("/usr/include");
+		data->ignoredFilePaths.Insert("third_party");
+		for (unsigned i = 0; i < scale; ++i)
+			data->paths.push_back(std::string(directories[i % 5]) + "file" + std::to_string(i % 101) + ".h");
+		return data;
+		}, [](Paths& data) {
+			size_t ignoredCount = 0;
+			for (const auto& path : data.paths)
+				ignoredCount += data.ignoredFilePaths.isIgnored(path);
+			sink = sink + ignoredCount;
+		});
+}
+
+static void NamespaceCases(Harness& harness, unsigned scale) {
+	// As NamespacesCache::Get on a miss: the parent name, the namespace name and "::", from the outermost namespace in
+	struct Namespaces {
+		std::vector<std::vector<std::string>> nested;
+	};
+	harness.Measure("namespace name building", scale, [scale]() {
+		auto data = std::make_unique<Namespaces>();
+		for (unsigned i = 0; i < scale; ++i) {
+			data->nested.push_back({ "company", "product" });
+			for (unsigned depth = 0; depth < i % 3; ++depth)
+				data->nested.back().push_back(depth ? "detail" : "module" + std::to_string(i % 13));
+		}
+		return data;
+		}, [](Namespaces& data) {
+			size_t length = 0;
+			for (const auto& nested : data.nested) {
+				std::string name;
+				for (const auto& nameSpace : nested)
+					name = name + nameSpace + "::";
+				length += name.size();
+			}
+			sink = sink + length;
+		});
+}
+
+static void UntypedCases(Harness& harness, unsigned scale) {
+	constexpr unsigned keysPerObject = 8;
+	unsigned objectCount = std::max(1u, scale / keysPerObject);
+	struct Objects {
+		std::vector<std::string> keys;
+		std::vector<untyped::Object> objects;
+	};
+	// Symbol data keys and index keys (Set(index++, ...)), as the graph serializers set them
+	auto keys = [objectCount]() {
+		auto data = std::make_unique<Objects>();
+		data->keys = { "id", "name", "namespace", "classType" };
+		data->objects.resize(objectCount);
+		return data;
+	};
+	auto set = [](Objects& data) {
+		for (size_t i = 0; i < data.objects.size(); ++i) {
+			auto& object = data.objects[i];
+			for (const auto& key : data.keys)
+				object.Set(key, "ns::Class" + std::to_string(i));
+			for (unsigned j = 0; j < keysPerObject - data.keys.size(); ++j)
+				object.Set((double)j, (double)i);
+		}
+	};
+	harness.Measure("untyped::Object::Set", (size_t)objectCount * keysPerObject, keys, set);
+	harness.Measure("untyped::Object copy", objectCount, [&keys, &set]() {
+		auto data = keys();
+		set(*data);
+		return data;
+		}, [](Objects& data) {
+			size_t total = 0;
+			for (const auto& object : data.objects) {
+				untyped::Object copy(object);
+				total += copy.GetTotal();
+			}
+			sink = sink + total;
+		});
+}
+
+// ----------------------------------------------------------------------------------------
+
+static bool SaveBaseline(const std::string& path, unsigned scale, const std::vector<Result>& results) {
+	Json::Value baseline;
+	baseline["scale"] = scale;
+	for (const auto& result : results) {
+		baseline["cases"][result.name]["nsPerOp"] = result.nsPerOp;
+		baseline["cases"][result.name]["allocationsPerOp"] = result.allocationsPerOp;
+	}
+	std::ofstream out(path);
+	out << baseline;
+	return (bool)out;
+}
+
+static bool LoadBaseline(const std::string& path, Json::Value& baseline) {
+	std::ifstream in(path);
+	Json::CharReaderBuilder builder;
+	std::string errors;
+	return in.is_open() && Json::parseFromStream(builder, in, &baseline, &errors) && baseline["cases"].isObject();
+}
+
+int main(int argc, const char** argv) {
+	unsigned scale = 20000, repetitions = 5;
+	double tolerance = 25;
+	std::string baselinePath = "", saveBaselinePath = "";
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--scale" && hasValue)
+			scale = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "--repetitions" && hasValue)
+			repetitions = std::max(1, std::stoi(argv[++i]));
+		else if (arg == "--baseline" && hasValue)
+			baselinePath = argv[++i];
+		else if (arg == "--save-baseline" && hasValue)
+			saveBaselinePath = argv[++i];
+		else if (arg == "--tolerance" && hasValue)
+			tolerance = std::max(0.0, std::stod(argv[++i]));
+		else {
+			std::cout << "--scale N, --repetitions N, --save-baseline PATH, --baseline PATH, --tolerance PERCENT\n";
+			return 1;
+		}
+	}
+
+	Json::Value baseline;
+	if (baselinePath != "" && !LoadBaseline(baselinePath, baseline)) {
+		std::cout << "Could not load the baseline " << baselinePath << "\n";
+		return 1;
+	}
+	if (baselinePath != "" && baseline["scale"].asUInt() != scale)
+		std::cout << "The baseline was run with --scale " << baseline["scale"].asUInt() << ": ns per op may not compare\n";
+
+	Harness harness(repetitions);
+	SymbolTableCases(harness, scale);
+	StructureCases(harness, scale);
+	MemberExprCases(harness, scale);
+	GraphCases(harness, scale);
+	ArenaCases(harness, scale);
+	IgnoredCases(harness, scale);
+	NamespaceCases(harness, scale);
+	UntypedCases(harness, scale);
+
+	bool regressed = false;
+	std::cout << std::left << std::setw(30) << "case" << std::right << std::setw(12) << "ns/op" << std::setw(12) << "allocs/op";
+	if (baselinePath != "")
+		std::cout << std::setw(14) << "baseline ns" << std::setw(16) << "baseline allocs" << std::setw(10) << "change";
+	std::cout << "\n";
+	for (const auto& result : harness.GetResults()) {
+		std::cout << std::left << std::setw(30) << result.name << std::right << std::fixed << std::setprecision(2)
+			<< std::setw(12) << result.nsPerOp << std::setw(12) << result.allocationsPerOp;
+		if (baselinePath != "") {
+			const auto& base = baseline["cases"][result.name];
+			if (base.isObject()) {
+				double baseNs = base["nsPerOp"].asDouble(), baseAllocations = base["allocationsPerOp"].asDouble();
+				double change = baseNs > 0 ? 100 * (result.nsPerOp - baseNs) / baseNs : 0;
+				bool slower = change > tolerance;
+				bool allocates = result.allocationsPerOp > baseAllocations + 0.005;		// the counts are exact, no tolerance
+				regressed = regressed || slower || allocates;
+				std::cout << std::setw(14) << baseNs << std::setw(16) << baseAllocations << std::setw(9) << std::showpos << change << std::noshowpos << "%";
+				if (slower || allocates)
+					std::cout << "  REGRESSION";
+			}
+			else {
+				std::cout << std::setw(14) << "-" << std::setw(16) << "-" << std::setw(10) << "new";
+			}
+		}
+		std::cout << "\n";
+	}
+
+	if (saveBaselinePath != "") {
+		if (!SaveBaseline(saveBaselinePath, scale, harness.GetResults())) {
+			std::cout << "Could not save the baseline to " << saveBaselinePath << "\n";
+			return 1;
+		}
+		std::cout << "Baseline saved to " << saveBaselinePath << "\n";
+	}
+	if (regressed)
+		std::cout << "Slower than the baseline by more than " << tolerance << "% or more allocations per op\n";
+	return regressed ? 1 : 0;
+}
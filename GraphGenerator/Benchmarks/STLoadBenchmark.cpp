@@ -0,0 +1,68 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include "STBinaryReader.h"
+#include "json/reader.h"
+
+/*
+	Time to get at the structures of an ST: parsing ST.json vs opening the binary ST (--binary-st) of the same run.
+	Every structure of ST.json is also looked up by id in the binary ST.
+
+	argv[1]: path/to/ST.json
+	argv[2]: path/to/binary ST
+*/
+
+using Clock = std::chrono::steady_clock;
+
+static double Ms(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, const char** argv) {
+	if (argc < 3) {
+		std::cout << "argv[1]: path/to/ST.json, argv[2]: path/to/binary ST\n";
+		return 1;
+	}
+
+	auto start = Clock::now();
+	Json::Value json;
+	{
+		std::ifstream in(argv[1]);
+		Json::CharReaderBuilder builder;
+		std::string errors;
+		if (!Json::parseFromStream(builder, in, &json, &errors)) {
+			std::cout << "Could not parse " << argv[1] << ": " << errors << "\n";
+			return 1;
+		}
+	}
+	double jsonMs = Ms(start);
+
+	start = Clock::now();
+	stBinary::STFile st;
+	if (!st.Open(argv[2])) {
+		std::cout << "Could not open " << argv[2] << "\n";
+		return 1;
+	}
+	double openMs = Ms(start);
+
+	const auto& structures = json["structures"];
+	auto ids = structures.isObject() ? structures.getMemberNames() : std::vector<std::string>();
+	start = Clock::now();
+	size_t found = 0, methods = 0;
+	for (const auto& id : ids) {
+		if (auto* structure = st.FindStructure(id)) {
+			++found;
+			methods += st.GetMethods(*structure).size();
+		}
+	}
+	double lookupMs = Ms(start);
+
+	std::cout << "ST.json parse:        " << jsonMs << " ms\n";
+	std::cout << "binary ST open:       " << openMs << " ms\n";
+	std::cout << "binary ST lookups:    " << lookupMs << " ms (" << ids.size() << " structures, " << methods << " methods)\n";
+	if (found != ids.size() || ids.size() != st.GetStructures().size()) {
+		std::cout << "MISMATCH: " << ids.size() << " structures in ST.json, " << st.GetStructures().size() << " in the binary ST, " << found << " found\n";
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,371 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <algorithm>
+#include "DependenciesMining.h"
+#include "GraphGeneration.h"
+#include "STToJson.h"
+#include "STBinaryWriter.h"
+#include "json/reader.h"
+#include "json/writer.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+/*
+	Scaling of the pipeline with the size of the mined codebase.
+	Generates a synthetic project (argv[1]) with its compile_commands.json, then runs the stages of main over it:
+	CreateClangTool, GenetareDependenciesGraph, CSRGraph, WriteST and WriteSTBinary.
+	Reports the time, the peak RSS of the process at the end (so far: it never goes down) and the output of every stage,
+	and appends them with the configuration to the results (a JSON array of runs, to chart across sizes and versions).
+
+	The project: classes (in namespace synthetic) spread over files of classes-per-file, each file a header and a source.
+	In a file the classes form an inheritance tree (fan-out derived classes per class), each class has (fields) int fields,
+	a pointer to a class of the previous file, a field of a template nested (template-depth) deep and (methods) methods,
+	defined in the source, each with (member-exprs) member expressions on this, on its argument and on the pointer.
+
+	argv[1]: directory to generate the project in
+	--classes N (default: 1000), --classes-per-file N (default: 50), --fan-out N (default: 2), --template-depth N (default: 2),
+	--fields N (default: 4), --methods N (default: 4), --member-exprs N (per method, default: 4)
+	--jobs N: as in main, --engine matchers|single-pass: the mining engine (single-pass is not offered by main)
+	--results PATH: (default: argv[1]/ScalingResults.json), --label TEXT: the version mined with (e.g. a commit)
+*/
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+struct ProjectConfig {
+	unsigned classes = 1000;
+	unsigned classesPerFile = 50;
+	unsigned fanOut = 2;
+	unsigned templateDepth = 2;
+	unsigned fields = 4;
+	unsigned methods = 4;
+	unsigned memberExprs = 4;
+};
+
+struct ProjectStats {
+	unsigned files = 0;
+	size_t lines = 0;
+	size_t bytes = 0;
+};
+
+class SyntheticProject {
+private:
+	const ProjectConfig& config;
+	std::string dir;
+	ProjectStats stats;
+
+	void WriteFile(const std::string& name, const std::string& contents) {
+		std::ofstream file(dir + "/" + name, std::ios::binary);
+		file << contents;
+		++stats.files;
+		stats.lines += std::count(contents.begin(), contents.end(), '\n');
+		stats.bytes += contents.size();
+	}
+
+	unsigned First(unsigned file) const { return file * config.classesPerFile; }
+	unsigned Last(unsigned file) const { return std::min(config.classes, First(file + 1)); }
+
+	// The class of the previous file (none for the first file) pointed to by a class
+	unsigned Linked(unsigned file, unsigned i) const {
+		return First(file - 1) + (i - First(file)) % config.classesPerFile;
+	}
+
+	// The class of the file a method of a class takes
+	unsigned Argument(unsigned file, unsigned i, unsigned method) const {
+		return First(file) + (i - First(file) + 7 * method + 1) % (Last(file) - First(file));
+	}
+
+	std::string Header(unsigned file) const {
+		std::ostringstream out;
+		out << "#pragma once\n";
+		if (config.templateDepth)
+			out << "#include \"templates.h\"\n";
+		out << "\nnamespace synthetic {\n\n";
+		for (unsigned i = First(file); i < Last(file); ++i)
+			out << "struct C" << i << ";\n";
+		for (unsigned i = First(file); file && i < Last(file); ++i)
+			out << "struct C" << Linked(file, i) << ";\n";
+		out << "\n";
+		for (unsigned i = First(file); i < Last(file); ++i) {
+			unsigned local = i - First(file);
+			out << "struct C" << i;
+			if (local)
+				out << " : public C" << First(file) + (local - 1) / std::max(1u, config.fanOut);
+			out << " {\n";
+			for (unsigned f = 0; f < config.fields; ++f)
+				out << "\tint f" << f << ";\n";
+			if (file)
+				out << "\tC" << Linked(file, i) << "* link;\n";
+			if (config.templateDepth)
+				out << "\tWrap" << config.templateDepth - 1 << "<C" << Argument(file, i, 0) << "> wrapped;\n";
+			for (unsigned m = 0; m < config.methods; ++m)
+				out << "\tint m" << m << "(C" << Argument(file, i, m) << "* other);\n";
+			out << "};\n\n";
+		}
+		out << "}\n";
+		return out.str();
+	}
+
+	std::string Source(unsigned file) const {
+		std::ostringstream out;
+		out << "#include \"h" << file << ".h\"\n";
+		if (file)
+			out << "#include \"h" << file - 1 << ".h\"\n";
+		out << "\nnamespace synthetic {\n\n";
+		const char* objects[] = { "this", "other", "link" };
+		unsigned objectCount = file ? 3 : 2;
+		for (unsigned i = First(file); i < Last(file); ++i) {
+			for (unsigned m = 0; m < config.methods; ++m) {
+				out << "int C" << i << "::m" << m << "(C" << Argument(file, i, m) << "* other) {\n";
+				out << "\tint sum = 0;\n";
+				for (unsigned e = 0; config.fields && e < config.memberExprs; ++e)
+					out << "\tsum += " << objects[e % objectCount] << "->f" << (m + e) % config.fields << ";\n";
+				out << "\treturn sum;\n}\n\n";
+			}
+		}
+		out << "}\n";
+		return out.str();
+	}
+
+	std::string Templates() const {
+		std::ostringstream out;
+		out << "#pragma once\n\nnamespace synthetic {\n\n";
+		out << "template<typename T> struct Wrap0 {\n\tT* value;\n};\n";
+		for (unsigned d = 1; d < config.templateDepth; ++d)
+			out << "\ntemplate<typename T> struct Wrap" << d << " {\n\tWrap" << d - 1 << "<T> inner;\n};\n";
+		out << "\n}\n";
+		return out.str();
+	}
+
+public:
+	SyntheticProject(const ProjectConfig& config, const std::string& dir) : config(config), dir(fs::absolute(dir).generic_string()) {}
+
+	// Writes the files and the compile_commands.json (returns its path)
+	std::string Generate() {
+		fs::create_directories(dir);
+		if (config.templateDepth)
+			WriteFile("templates.h", Templates());
+		Json::Value cmpDB(Json::arrayValue);
+		unsigned files = (config.classes + config.classesPerFile - 1) / config.classesPerFile;
+		for (unsigned file = 0; file < files; ++file) {
+			std::string source = "s" + std::to_string(file) + ".cpp";
+			WriteFile("h" + std::to_string(file) + ".h", Header(file));
+			WriteFile(source, Source(file));
+			Json::Value command;
+			command["directory"] = dir;
+			command["command"] = "clang++ -std=c++17 -c " + source;
+			command["file"] = dir + "/" + source;
+			cmpDB.append(command);
+		}
+		std::string cmpDBPath = dir + "/compile_commands.json";
+		std::ofstream cmpDBFile(cmpDBPath);
+		cmpDBFile << cmpDB;
+		return cmpDBPath;
+	}
+
+	const ProjectStats& GetStats() const { return stats; }
+};
+
+// ----------------------------------------------------------------------------------------
+
+static size_t PeakRSSBytes() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage))
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss;									// bytes
+#else
+	return (size_t)usage.ru_maxrss * 1024;					// KB
+#endif
+#endif
+}
+
+static size_t FileSize(const std::string& path) {
+	std::error_code error;
+	auto size = fs::file_size(path, error);
+	return error ? 0 : (size_t)size;
+}
+
+class Stages {
+private:
+	Json::Value stages = Json::Value(Json::arrayValue);
+	std::string name;
+	Clock::time_point start;
+public:
+	void Start(const std::string& name) {
+		this->name = name;
+		start = Clock::now();
+	}
+
+	// output: the sizes of what the stage produced
+	void End(const Json::Value& output) {
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		Json::Value stage;
+		stage["name"] = name;
+		stage["ms"] = ms;
+		stage["peakRSSBytes"] = (Json::UInt64)PeakRSSBytes();
+		stage["output"] = output;
+		stages.append(stage);
+		Json::StreamWriterBuilder builder;
+		builder["indentation"] = "";
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2) << std::setw(12) << ms
+			<< std::setw(12) << PeakRSSBytes() / (1024.0 * 1024.0) << "  " << Json::writeString(builder, output) << "\n";
+	}
+
+	const Json::Value& Get() const { return stages; }
+};
+
+static bool AppendResult(const std::string& path, const Json::Value& run) {
+	Json::Value results(Json::arrayValue);
+	{
+		std::ifstream in(path);
+		Json::CharReaderBuilder builder;
+		std::string errors;
+		if (in.is_open() && !Json::parseFromStream(builder, in, &results, &errors))
+			return false;
+		if (!results.isArray())
+			return false;
+	}
+	results.append(run);
+	std::ofstream out(path);
+	out << results;
+	return (bool)out;
+}
+
+static void PrintArgInfo() {
+	std::cout << "argv[1]: directory to generate the project in\n";
+	std::cout << "--classes N, --classes-per-file N, --fan-out N, --template-depth N, --fields N, --methods N, --member-exprs N\n";
+	std::cout << "--jobs N, --engine matchers|single-pass, --results PATH, --label TEXT\n";
+}
+
+int main(int argc, const char** argv) {
+	if (argc < 2) {
+		PrintArgInfo();
+		return 1;
+	}
+	std::string dir = argv[1];
+	ProjectConfig config;
+	dependenciesMining::MiningOptions options;
+	std::string resultsPath = dir + "/ScalingResults.json";
+	std::string label = "";
+	for (int i = 2; i < argc; ++i) {
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		auto number = [&]() { return (unsigned)std::max(0, std::stoi(argv[++i])); };
+		if (arg == "--classes" && hasValue)
+			config.classes = std::max(1u, number());
+		else if (arg == "--classes-per-file" && hasValue)
+			config.classesPerFile = std::max(1u, number());
+		else if (arg == "--fan-out" && hasValue)
+			config.fanOut = std::max(1u, number());
+		else if (arg == "--template-depth" && hasValue)
+			config.templateDepth = number();
+		else if (arg == "--fields" && hasValue)
+			config.fields = number();
+		else if (arg == "--methods" && hasValue)
+			config.methods = number();
+		else if (arg == "--member-exprs" && hasValue)
+			config.memberExprs = number();
+		else if (arg == "--jobs" && hasValue)
+			options.jobs = number();
+		else if (arg == "--engine" && hasValue)
+			options.engine = (std::string(argv[++i]) == "single-pass") ? dependenciesMining::MiningEngine::SinglePass : dependenciesMining::MiningEngine::Matchers;
+		else if (arg == "--results" && hasValue)
+			resultsPath = argv[++i];
+		else if (arg == "--label" && hasValue)
+			label = argv[++i];
+		else {
+			PrintArgInfo();
+			return 1;
+		}
+	}
+
+	std::cout << std::left << std::setw(28) << "stage" << std::right << std::setw(12) << "ms" << std::setw(12) << "peak RSS MB" << "  output\n";
+	Stages stages;
+	Json::Value output;
+
+	stages.Start("Generate");
+	SyntheticProject project(config, dir);
+	std::string cmpDBPath = project.Generate();
+	output["files"] = project.GetStats().files;
+	output["lines"] = (Json::UInt64)project.GetStats().lines;
+	output["bytes"] = (Json::UInt64)project.GetStats().bytes;
+	stages.End(output);
+
+	stages.Start("CreateClangTool");
+	std::vector<std::string> srcs, headers;
+	int result = dependenciesMining::CreateClangTool(cmpDBPath.c_str(), srcs, headers, "", "", options);
+	size_t symbols = std::distance(dependenciesMining::structuresTable.begin(), dependenciesMining::structuresTable.end());
+	output = Json::Value();
+	output["structures"] = (Json::UInt64)symbols;
+	output["sources"] = (Json::UInt64)srcs.size();
+	output["headers"] = (Json::UInt64)headers.size();
+	stages.End(output);
+
+	stages.Start("GenetareDependenciesGraph");
+	auto dependenciesGraph = graphGeneration::GenetareDependenciesGraph(dependenciesMining::structuresTable);
+	stages.End(Json::Value(Json::objectValue));
+
+	stages.Start("CSRGraph");
+	graph::CSRGraph graph(dependenciesGraph);
+	output = Json::Value();
+	output["nodes"] = graph.NodesSize();
+	output["edges"] = graph.EdgesSize();
+	stages.End(output);
+
+	stages.Start("WriteST");
+	std::string jsonSTPath = dir + "/ST.json";
+	{
+		std::ofstream jsonSTFile(jsonSTPath);
+		stToJson::WriteST(jsonSTFile, dependenciesMining::structuresTable, graph, srcs, headers);
+	}
+	output = Json::Value();
+	output["bytes"] = (Json::UInt64)FileSize(jsonSTPath);
+	stages.End(output);
+
+	stages.Start("WriteSTBinary");
+	std::string binarySTPath = dir + "/ST.bin";
+	stBinary::WriteSTBinary(binarySTPath, dependenciesMining::structuresTable, graph, srcs, headers);
+	output = Json::Value();
+	output["bytes"] = (Json::UInt64)FileSize(binarySTPath);
+	stages.End(output);
+
+	Json::Value run;
+	run["label"] = label;
+	run["time"] = (Json::Int64)std::time(nullptr);
+	run["config"]["classes"] = config.classes;
+	run["config"]["classesPerFile"] = config.classesPerFile;
+	run["config"]["fanOut"] = config.fanOut;
+	run["config"]["templateDepth"] = config.templateDepth;
+	run["config"]["fields"] = config.fields;
+	run["config"]["methods"] = config.methods;
+	run["config"]["memberExprs"] = config.memberExprs;
+	run["config"]["jobs"] = options.jobs;
+	run["config"]["engine"] = options.engine == dependenciesMining::MiningEngine::SinglePass ? "single-pass" : "matchers";
+	run["result"] = result;
+	run["stages"] = stages.Get();
+	if (!AppendResult(resultsPath, run)) {
+		std::cout << "Could not append the results to " << resultsPath << "\n";
+		return 1;
+	}
+	std::cout << "Results appended to " << resultsPath << "\n";
+	return result;
+}
@@ -0,0 +1,192 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include "uobject_untyped.h"
+
+/*
+	Building and copying untyped node objects, as graph generation did before the typed node records:
+	per structure an object with its symbol data, srcInfo, bases / friends / templateArguments arrays
+	(Set(index++, ...)) and nested field and method objects, each handed over to the caller with
+	innerObj = std::move(data). The nested objects are Set as lvalues (copied), as the generator did, so that
+	this also builds against the untyped library before a change, to compare.
+	Reports the fastest of (repetitions) runs and the heap allocations of a run.
+
+	argv[1]: (optional) structures (default: 2000)
+	argv[2]: (optional) methods per structure (default: 10)
+	argv[3]: (optional) repetitions (default: 5)
+*/
+
+using namespace untyped;
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+static void SetSrcInfo(Object& data, const char* key, const std::string& fileName, unsigned line, unsigned column) {
+	Object srcInfo;
+	srcInfo.Set("fileName", fileName);
+	srcInfo.Set("line", (double)line);
+	srcInfo.Set("column", (double)column);
+	data.Set(key, srcInfo);
+}
+
+class NodeBuilder {
+	Object innerObj;
+
+	void BuildDefinition(const std::string& name, const std::string& type, unsigned line) {
+		Object data;
+		data.Set("id", name);
+		data.Set("name", name);
+		data.Set("namespace", "ns::");
+		SetSrcInfo(data, "srcInfo", "file.h", line, 1);
+		data.Set("classType", "Definition");
+		data.Set("type", type);
+		innerObj = std::move(data);
+	}
+
+	void BuildMethod(const std::string& name, const std::string& other, unsigned line) {
+		Object data;
+		data.Set("id", name);
+		data.Set("name", name);
+		data.Set("namespace", "ns::");
+		SetSrcInfo(data, "srcInfo", "file.h", line, 1);
+		data.Set("classType", "Method");
+		data.Set("methodType", "UserMethod");
+		data.Set("returnType", other);
+
+		Object argsObj, defsObj;
+		for (unsigned k = 0; k < 2; ++k) {
+			BuildDefinition(name + "::arg" + std::to_string(k), other, line);
+			argsObj.Set(name + "::arg" + std::to_string(k), innerObj);
+			BuildDefinition(name + "::var" + std::to_string(k), other, line);
+			defsObj.Set(name + "::var" + std::to_string(k), innerObj);
+		}
+		data.Set("arguments", argsObj);
+		data.Set("definitions", defsObj);
+		Object templArgsObj;
+		data.Set("templateArguments", templArgsObj);
+
+		Object memberObj;
+		memberObj.Set("name", "field0");
+		memberObj.Set("type", other);
+		memberObj.Set("memberType", "ClassField");
+		SetSrcInfo(memberObj, "locEnd", "file.h", line, 20);
+		Object membersObj;
+		membersObj.Set(0.0, memberObj);
+		Object memberExprObj;
+		memberExprObj.Set("expr", "arg0.field0");
+		SetSrcInfo(memberExprObj, "srcInfo", "file.h", line, 10);
+		memberExprObj.Set("members", membersObj);
+		Object memberExprsObj;
+		memberExprsObj.Set("file.h:" + std::to_string(line) + ":10", memberExprObj);
+		data.Set("memberExprs", memberExprsObj);
+
+		innerObj = std::move(data);
+	}
+
+public:
+	Object BuildStructure(unsigned i, unsigned structureCount, unsigned methodCount) {
+		std::string name = "ns::Class" + std::to_string(i);
+		std::string other = "ns::Class" + std::to_string((i + 1) % structureCount);
+		std::string previous = "ns::Class" + std::to_string(i ? i - 1 : 0);
+		Object nodeData;
+		nodeData.Set("id", name);
+		nodeData.Set("name", name);
+		nodeData.Set("namespace", "ns::");
+		SetSrcInfo(nodeData, "srcInfo", "file.h", i, 1);
+		nodeData.Set("classType", "Structure");
+		nodeData.Set("structureType", "Class");
+
+		Object basesObj, friendsObj, templArgsObj;
+		double index = 0;
+		for (unsigned j = 0; j < 3; ++j)
+			basesObj.Set(index++, previous);
+		index = 0;
+		if (i % 2)
+			friendsObj.Set(index++, previous);
+		index = 0;
+		for (unsigned j = 0; j < 2; ++j)
+			templArgsObj.Set(index++, other);
+		nodeData.Set("bases", basesObj);
+		nodeData.Set("friends", friendsObj);
+		nodeData.Set("templateArguments", templArgsObj);
+
+		Object fieldsObj;
+		for (unsigned j = 0; j < 4; ++j) {
+			std::string fieldName = name + "::field" + std::to_string(j);
+			BuildDefinition(fieldName, other, i);
+			fieldsObj.Set(fieldName, innerObj);
+		}
+		nodeData.Set("fields", fieldsObj);
+
+		Object methodsObj;
+		for (unsigned j = 0; j < methodCount; ++j) {
+			std::string methodName = name + "::method" + std::to_string(j) + "()";
+			BuildMethod(methodName, other, i);
+			methodsObj.Set(methodName, innerObj);
+		}
+		nodeData.Set("methods", methodsObj);
+		return nodeData;
+	}
+};
+
+// The bases are read back as the graph serializer did: through ForEach over the index keys
+static size_t Visit(const std::vector<Object>& nodes) {
+	size_t count = 0;
+	for (const auto& node : nodes) {
+		node["bases"].ToObject().ForEach([&count](const Value& key, const Value& value) {
+			count += value.ToString().size() + (size_t)key.ToNumber();
+			});
+		count += node["methods"].ToObject().GetTotal();
+	}
+	return count;
+}
+
+int main(int argc, const char** argv) {
+	unsigned structureCount = (argc >= 2) ? std::max(1, std::stoi(argv[1])) : 2000;
+	unsigned methodCount = (argc >= 3) ? std::max(0, std::stoi(argv[2])) : 10;
+	unsigned repetitions = (argc >= 4) ? std::max(1, std::stoi(argv[3])) : 5;
+
+	double bestMs = 0;
+	size_t runAllocations = 0, count = 0;
+	for (unsigned r = 0; r < repetitions; ++r) {
+		size_t before = allocations.load();
+		auto start = Clock::now();
+		{
+			NodeBuilder builder;
+			std::vector<Object> nodes;
+			nodes.reserve(structureCount);
+			for (unsigned i = 0; i < structureCount; ++i)
+				nodes.push_back(builder.BuildStructure(i, structureCount, methodCount));
+			std::vector<Object> copies(nodes);
+			count = Visit(copies);
+		}
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		bestMs = r ? std::min(bestMs, ms) : ms;
+		runAllocations = allocations.load() - before;
+	}
+
+	std::cout << structureCount << " structures, " << methodCount << " methods per structure\n";
+	std::cout << std::fixed << std::setprecision(2) << "build + copy + visit: " << bestMs << " ms, " << runAllocations << " heap allocations (" << count << ")\n";
+	return 0;
+}
@@ -1,9 +1,23 @@
 #include "DependenciesMining.h"
 #include "Utilities.h"
+#include "MiningCache.h"
+#include "TUTimings.h"
+#include "SinglePassMiner.h"
+#include "Tracing.h"
 #include "clang/Frontend/CompilerInstance.h"
+#include "clang/Frontend/MultiplexConsumer.h"
 #include "clang/Lex/PreprocessorOptions.h"
 //#include "clang/Tooling/CompilationDatabase.h"
+#include "llvm/Support/VirtualFileSystem.h"
 #include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <unordered_set>
+#include <optional>
+#include <chrono>
 
 #define CLASS_DECL "ClassDecl"
 #define STRUCT_DECL "StructDecl"
@@ -26,25 +40,161 @@ SymbolTable dependenciesMining::structuresTable;
 std::unordered_map<std::string, Ignored*> dependenciesMining::ignored;
 
 void initializeIgnored(const std::string& ignoredFiles, const std::string& ignoredNamespaces = "") {
+	for (auto& it : ignored)		// of a previous CreateClangTool (the skeleton pass of --progressive)
+		delete it.second;
 	ignored["filePaths"] = new IgnoredFilePaths(ignoredFiles);
 	ignored["namespaces"] = new IgnoredNamespaces(ignoredNamespaces);
 }
 
+bool IgnoredFileIDs::IsIgnored(const PresumedLoc& loc) {
+	auto it = verdicts.find(loc.getFileID().getHashValue());
+	if (it == verdicts.end())
+		it = verdicts.emplace(loc.getFileID().getHashValue(), ignored.at("filePaths")->isIgnored(loc.getFilename())).first;
+	return it->second;
+}
+
+const NamespaceInfo& NamespacesCache::Get(const RecordDecl* d) {
+	return Get(d->getEnclosingNamespaceContext());
+}
+
+const NamespaceInfo& NamespacesCache::Get(const DeclContext* context) {
+	context = context->getPrimaryContext();						// the same for every reopening of a namespace
+	auto it = namespaces.find(context);
+	if (it != namespaces.end())
+		return it->second;
+
+	NamespaceInfo info;
+	if (context->isNamespace()) {
+		const auto& parent = Get(context->getParent()->getEnclosingNamespaceContext());
+		info.name = parent.name + ((NamespaceDecl*)context)->getNameAsString() + "::";
+	}
+	info.ignored = ignored.at("namespaces")->isIgnored(info.name);
+	return namespaces.emplace(context, std::move(info)).first->second;
+}
+
+static std::atomic<size_t> namingHits{ 0 };
+static std::atomic<size_t> namingMisses{ 0 };
+
+const DeclName& NamesCache::Get(const RecordDecl* d) {
+	auto* key = d->getCanonicalDecl();
+	auto it = names.find(key);
+	if (it != names.end()) {
+		++hits;
+		return it->second;
+	}
+	++misses;
+	DeclName name;
+	name.name = GetFullStructureName(d);
+	name.id = InternID(name.name);
+	return names.emplace(key, std::move(name)).first->second;
+}
+
+const DeclName& NamesCache::Get(const CXXMethodDecl* d) {
+	auto it = names.find(d);
+	if (it != names.end()) {
+		++hits;
+		return it->second;
+	}
+	++misses;
+	DeclName name;
+	name.name = GetFullMethodName(d);
+	name.id = InternID(name.name);
+	return names.emplace(d, std::move(name)).first->second;
+}
+
+const DeclName& NamesCache::GetType(const QualType& type) {
+	if (type->isPointerType() || type->isReferenceType())
+		return Get(type->getPointeeType()->getAsCXXRecordDecl());
+	return Get(type->getAsCXXRecordDecl());
+}
+
+void NamesCache::Clear() {
+	namingHits += hits;
+	namingMisses += misses;
+	hits = misses = 0;
+	names.clear();
+}
+
+NamingStats dependenciesMining::GetNamingStats() {
+	NamingStats stats;
+	stats.hits = namingHits;
+	stats.misses = namingMisses;
+	return stats;
+}
+
+// A template specialization (class or function, implicit or explicit) or a member of one
+static bool IsTemplateSpecialization(const Decl* d) {
+	if (const auto* record = dyn_cast<CXXRecordDecl>(d))
+		return record->getTemplateSpecializationKind() != TSK_Undeclared;
+	if (const auto* function = dyn_cast<FunctionDecl>(d))
+		return function->getTemplateSpecializationKind() != TSK_Undeclared;
+	return false;
+}
+
+bool MinedDecls::Insert(const Decl* d, const SourceManager& sm) {
+	if (d->isImplicit() || d->getLocation().isInvalid() || d->getLocation().isMacroID())
+		return true;
+	if (const auto* record = dyn_cast<RecordDecl>(d)) {
+		if (!record->isThisDeclarationADefinition())
+			return true;
+	}
+	if (IsTemplateSpecialization(d))
+		return true;
+	for (const auto* context = d->getDeclContext(); context; context = context->getParent()) {
+		if (IsTemplateSpecialization(cast<Decl>(context)))
+			return true;
+	}
+
+	auto location = sm.getDecomposedLoc(d->getLocation());
+	const auto* file = sm.getFileEntryForID(location.first);
+	if (!file)
+		return true;
+	const auto& fileID = file->getUniqueID();
+	return mined.insert({ fileID.getDevice(), fileID.getFile(), location.second, (unsigned)d->getKind() }).second;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+/*
+	Record info computed on every call. 
+	The returned reference is valid until the next call.
+*/
+const RecordInfo& DeclMiner::GetRecordInfo(const RecordDecl* d) {
+	recordInfo = RecordInfo(d, caches);
+	return recordInfo;
+}
+
+RecordInfo::RecordInfo(const RecordDecl* d, TranslationUnitCaches& caches) {
+	ignoredDecl = isIgnoredDecl(d);
+	const auto& namespaceInfo = caches.namespaces.Get(d);
+	nameSpace = namespaceInfo.name;
+	ignoredNamespace = namespaceInfo.ignored;
+	if (!ignoredNamespace)
+		id = caches.names.Get(d).id;
+}
+
 // ----------------------------------------------------------------------------------------------
 
 // Handle all the Classes and Structs and the Bases
 void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
-	const CXXRecordDecl* d;
-	Structure structure;
-	if ((d = result.Nodes.getNodeAs<CXXRecordDecl>(CLASS_DECL))) {
-		structure.SetStructureType(StructureType::Class);
+	tracing::Total total("ClassDeclsCallback");
+	if (const auto* d = result.Nodes.getNodeAs<CXXRecordDecl>(CLASS_DECL)) {
+		DeclMiner(table, mined, result.SourceManager, caches).MineRecord(d, StructureType::Class);
 	}
-	else if ((d = result.Nodes.getNodeAs<CXXRecordDecl>(STRUCT_DECL))) {
-		structure.SetStructureType(StructureType::Struct);
+	else if (const auto* d = result.Nodes.getNodeAs<CXXRecordDecl>(STRUCT_DECL)) {
+		DeclMiner(table, mined, result.SourceManager, caches).MineRecord(d, StructureType::Struct);
 	}
 	else {
 		assert(0);
 	}
+}
+
+void DeclMiner::MineRecord(const CXXRecordDecl* d, StructureType structureType) {
+	if (!mined.Insert(d, *sm))
+		return;
+
+	Structure structure;
+	structure.SetStructureType(structureType);
 
 	if (isIgnoredDecl(d)) {
 		return;
@@ -81,30 +231,28 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 		assert(0);
 	}
 
-	auto srcLocation = result.SourceManager->getPresumedLoc(d->getLocation());
+	auto srcLocation = sm->getPresumedLoc(d->getLocation());
 	structure.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
-	if (ignored["filePaths"]->isIgnored(srcLocation.getFilename())) {
+	if (caches.ignoredFiles.IsIgnored(srcLocation)) {
 		return;
 	}
 
-	auto structID = GetIDfromDecl(d);	
-	//assert(structID); 
-	structure.SetName(GetFullStructureName(d));
-	structure.SetID(structID);
-
 	// Namespace
-	std::string fullEnclosingNamespace = GetFullNamespaceName(d);
-	if (ignored["namespaces"]->isIgnored(fullEnclosingNamespace)) {
+	const auto& info = GetRecordInfo(d);
+	if (info.ignoredNamespace) {
 		return;
 	}
-	structure.SetNamespace(fullEnclosingNamespace);
+	structure.SetNamespace(info.nameSpace);
+
+	structure.SetName(caches.names.Get(d).name);
+	structure.SetID(info.id);
 
 
 	// Templates 
 	if (!d->hasDefinition()) {															// Templates that has Declaration only
 		assert(structure.GetStructureType() == StructureType::TemplateDefinition);
 		structure.SetStructureType(StructureType::Undefined);
-		structuresTable.Install(structure.GetID(), structure);
+		table.Install(structure.GetID(), structure);
 		return;
 	}
 
@@ -116,27 +264,27 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 
 		Structure* templateParent;
 		if (structure.IsTemplateInstantiationSpecialization()) {								// template Instantiation Specialization
-			auto* parent = d->getTemplateInstantiationPattern();
-			parentID = GetIDfromDecl(parent); 
+			const auto& parent = caches.names.Get(d->getTemplateInstantiationPattern());
+			parentID = parent.id; 
 			//assert(parentID); 
-			parentName = GetFullStructureName(parent);
-			templateParent = (Structure*)structuresTable.Lookup(parentID);
+			parentName = parent.name;
+			templateParent = (Structure*)table.Lookup(parentID);
 		}
 		else {																					// template Full and Parsial Specialization
 			parentName = d->getQualifiedNameAsString();	
-			templateParent = (Structure*)structuresTable.Lookup(parentName);
+			templateParent = (Structure*)table.Lookup(InternID(parentName));
 			assert(templateParent);
 			parentID = templateParent->GetID();
 		}
 		if (!templateParent)
-			templateParent = (Structure*)structuresTable.Install(parentID, parentName);
+			templateParent = (Structure*)table.Install(parentID, parentName);
 		structure.SetTemplateParent(templateParent);
 
 		//Template Arguments		
 		auto* temp = (ClassTemplateSpecializationDecl*)d;
 		for (unsigned i = 0; i < temp->getTemplateArgs().size(); ++i) {
 			const auto& templateArg = temp->getTemplateArgs()[i];
-			TemplateArgsVisit(templateArg, [](TemplateArgument templateArg, Structure *structure) {
+			TemplateArgsVisit(templateArg, [](TemplateArgument templateArg, Structure *structure, SymbolTable* table, NamesCache* names) {
 					RecordDecl* d = nullptr;
 					if (templateArg.getKind() == TemplateArgument::Template) {
 						d = (RecordDecl*)templateArg.getAsTemplateOrTemplatePattern().getAsTemplateDecl()->getTemplatedDecl();
@@ -147,15 +295,14 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 					if (d || GetTemplateArgType(templateArg)->isStructureOrClassType()) {
 						if (!d)
 							d = GetTemplateArgType(templateArg)->getAsCXXRecordDecl();			
-						std::string argStructName = GetFullStructureName(d);
-						auto argStructID = GetIDfromDecl(d);	
-						//assert(argStructID);
-						Structure* argStruct = (Structure*)structuresTable.Lookup(argStructID);
-						if(argStruct == nullptr)
-							argStruct = (Structure*)structuresTable.Install(argStructID, argStructName);
-						structure->InstallTemplateSpecializationArguments(argStructID, argStruct);
+						const auto& argStruct = names->Get(d);
+						//assert(argStruct.id);
+						Structure* argStructure = (Structure*)table->Lookup(argStruct.id);
+						if(argStructure == nullptr)
+							argStructure = (Structure*)table->Install(argStruct.id, argStruct.name);
+						structure->InstallTemplateSpecializationArguments(argStruct.id, argStructure);
 					}
-				}, &structure);			
+				}, &structure, &table, &caches.names);			
 		}
 	}
 	
@@ -165,13 +312,12 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 		auto* baseRecord = it.getType()->getAsCXXRecordDecl();	
 		if (baseRecord == nullptr)										// otan base einai template or partial specialization Ignored
 			continue;
-		std::string baseName = GetFullStructureName(baseRecord);
-		auto baseID = GetIDfromDecl(baseRecord); 
-		//assert(baseID);
-		Structure* base = (Structure*)structuresTable.Lookup(baseID);
+		const auto& baseName = caches.names.Get(baseRecord);
+		//assert(baseName.id);
+		Structure* base = (Structure*)table.Lookup(baseName.id);
 		if (!base)
-			base = (Structure*)structuresTable.Install(baseID, baseName);
-		structure.InstallBase(baseID, base);
+			base = (Structure*)table.Install(baseName.id, baseName.name);
+		structure.InstallBase(baseName.id, base);
 	}
 
 	// Friends 
@@ -181,13 +327,12 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 			auto parent = type->getType()->getAsCXXRecordDecl();
 			if (!parent)																					// ignore decls that does not have definitions
 				continue;
-			auto parentID = GetIDfromDecl(parent); 
-			//assert(parentID);
-			std::string parentName = GetFullStructureName(type->getType()->getAsCXXRecordDecl()) ;
-			Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
+			const auto& parentName = caches.names.Get(parent);
+			//assert(parentName.id);
+			Structure* parentStructure = (Structure*)table.Lookup(parentName.id);
 			if (!parentStructure)
-				parentStructure = (Structure*)structuresTable.Install(parentID, parentName);
-			structure.InstallFriend(parentID, parentStructure);
+				parentStructure = (Structure*)table.Install(parentName.id, parentName.name);
+			structure.InstallFriend(parentName.id, parentStructure);
 		}
 		else {																								// Methods			
 			auto* decl = it->getFriendDecl();
@@ -204,11 +349,10 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 				else {
 					methodDecl = (CXXMethodDecl*)decl;
 				}
-				std::string methodName = GetFullMethodName(methodDecl);
 				auto* parentClass = methodDecl->getParent();
-				auto parentClassID = GetIDfromDecl(parentClass);	
+				auto parentClassID = caches.names.Get(parentClass).id;	
 				//assert(parentClassID);
-				Structure* parentStructure = (Structure*)structuresTable.Lookup(parentClassID);
+				Structure* parentStructure = (Structure*)table.Lookup(parentClassID);
 				if (!parentStructure) continue;
 				// meta thn allagh se ids ws keys den krataw info gia to idio to method alla mono gia to structure pou anoikei
 				structure.InstallFriend(parentClassID, parentStructure);
@@ -219,16 +363,12 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 				if (!structureDefinition)																	// ignore decls that does not have definitions
 					continue;	
 
-				auto parentID = GetIDfromDecl(structureDefinition);
-				auto parentName = GetFullStructureName(structureDefinition);
-				Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
+				const auto& parentName = caches.names.Get(structureDefinition);
+				Structure* parentStructure = (Structure*)table.Lookup(parentName.id);
 				if (!parentStructure) {
-					parentStructure = (Structure*)structuresTable.Lookup(parentName);
-					if (!parentStructure) {
-						parentStructure = (Structure*)structuresTable.Install(parentID, parentName);
-					}
+					parentStructure = (Structure*)table.Install(parentName.id, parentName.name);
 				}
-				structure.InstallFriend(parentID, parentStructure);
+				structure.InstallFriend(parentName.id, parentStructure);
 			}
 		}
 	}
@@ -237,20 +377,17 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 	if (d->isCXXClassMember()) {
 		const auto* parent = d->getParent();
 		assert(parent);
-		std::string parentName = GetFullStructureName((RecordDecl*)parent);
-		auto parentID = GetIDfromDecl((RecordDecl*)parent);
-		//assert(parentID);
-		if (isIgnoredDecl((RecordDecl*)parent)) {
+		const auto& parentInfo = GetRecordInfo((RecordDecl*)parent);
+		if (parentInfo.ignoredDecl) {
 			return;
 		}
-		if (parentName != structure.GetName()) {
-			Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
-			auto* inst = d->getInstantiatedFromMemberClass();
+		if (parentInfo.id != structure.GetID()) {
+			Structure* parentStructure = (Structure*)table.Lookup(parentInfo.id);
 			structure.SetNestedParent(parentStructure);
-			parentStructure->InstallNestedClass(structure.GetID(), (Structure*)structuresTable.Install(structure.GetID(), structure.GetName()));
+			parentStructure->InstallNestedClass(structure.GetID(), (Structure*)table.Install(structure.GetID(), structure.GetName()));
 		}
 	}
-	structuresTable.Install(structure.GetID(), structure);
+	table.Install(structure.GetID(), structure);
 	/*FindFieldStmt visitor;
 	visitor.TraverseAST(d->getASTContext());
 	auto fields = d->fields();
@@ -268,106 +405,99 @@ void ClassDeclsCallback::run(const MatchFinder::MatchResult& result) {
 
 // ----------------------------------------------------------------------------------------------
 // Hanlde all the Fields in classes/structs (non structure fields)
-void FeildDeclsCallback::installFundamentalField(const MatchFinder::MatchResult& result) {
-	if (const FieldDecl* d = result.Nodes.getNodeAs<FieldDecl>(FIELD_DECL)) {
-		auto* parent = d->getParent();
-
-		// Ignored
-		auto srcLocation = result.SourceManager->getPresumedLoc(d->getLocation());
-
-		std::string parentName = GetFullStructureName(parent);
-		std::string typeName = d->getType().getAsString();
-		ID_T parentID = GetIDfromDecl(parent);
-		//if (d->getType()->isPointerType() || d->getType()->isReferenceType()) {
-		//	typeName = GetFullStructureName(d->getType()->getPointeeType()->getAsRecordDecl()); // CXX
-		//	typeID = GetIDfromDecl(d->getType()->getPointeeType()->getAsRecordDecl());			// CXX
-		//}
-		//else {
-		//	typeName = GetFullStructureName(d->getType()->getAsCXXRecordDecl());
-		//	typeID = GetIDfromDecl(d->getType()->getAsCXXRecordDecl());
-		//}
+void DeclMiner::MineFundamentalField(const FieldDecl* d, const RecordInfo& parentInfo) {
+	// Ignored
+	auto srcLocation = sm->getPresumedLoc(d->getLocation());
+
+	std::string typeName = d->getType().getAsString();
+	ID_T parentID = parentInfo.id;
+	//if (d->getType()->isPointerType() || d->getType()->isReferenceType()) {
+	//	typeName = GetFullStructureName(d->getType()->getPointeeType()->getAsRecordDecl()); // CXX
+	//	typeID = GetIDfromDecl(d->getType()->getPointeeType()->getAsRecordDecl());			// CXX
+	//}
+	//else {
+	//	typeName = GetFullStructureName(d->getType()->getAsCXXRecordDecl());
+	//	typeID = GetIDfromDecl(d->getType()->getAsCXXRecordDecl());
+	//}
 
 
 
 
-		Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
+	Structure* parentStructure = (Structure*)table.Lookup(parentID);
 
-		//Structure* typeStructure = (Structure*)structuresTable.Lookup(typeID);
+	//Structure* typeStructure = (Structure*)table.Lookup(typeID);
 
 
-		//if (parentStructure->IsTemplateInstantiationSpecialization())		// insertion speciallization inherit its dependencies from the parent template
-		//	return;
-		//if (!typeStructure)
-		//	typeStructure = (Structure*)structuresTable.Install(typeID, typeName);
+	//if (parentStructure->IsTemplateInstantiationSpecialization())		// insertion speciallization inherit its dependencies from the parent template
+	//	return;
+	//if (!typeStructure)
+	//	typeStructure = (Structure*)table.Install(typeID, typeName);
 
-		auto fieldID = GetIDfromDecl(d);
-		//assert(fieldID);
-		Definition field(fieldID, d->getQualifiedNameAsString(), parentStructure->GetNamespace());
-		field.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
-		field.SetFullType(typeName);
-		auto* _field = parentStructure->InstallField(fieldID, field);
-		_field->SetAccessType((AccessType)d->getAccess());
-	}
+	auto fieldID = GetIDfromDecl(d);
+	//assert(fieldID);
+	Definition field(fieldID, d->getQualifiedNameAsString(), parentStructure->GetNamespace());
+	field.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+	field.SetFullType(typeName);
+	auto* _field = parentStructure->InstallField(fieldID, field);
+	_field->SetAccessType((AccessType)d->getAccess());
 }
 
 
 
-// Hanlde all the Fields in classes/structs (structure fields)
 void FeildDeclsCallback::run(const MatchFinder::MatchResult& result) {
+	tracing::Total total("FeildDeclsCallback");
 	if (const FieldDecl* d = result.Nodes.getNodeAs<FieldDecl>(FIELD_DECL)) {
+		DeclMiner(table, mined, result.SourceManager, caches).MineField(d);
+	}
+}
 
-		auto* parent = d->getParent();
+// Hanlde all the Fields in classes/structs (structure fields)
+void DeclMiner::MineField(const FieldDecl* d) {
+	if (!mined.Insert(d, *sm))
+		return;
 
-		// Ignored
-		auto srcLocation = result.SourceManager->getPresumedLoc(d->getLocation());
-		if (ignored["filePaths"]->isIgnored(srcLocation.getFilename())) {
-			return;
-		}
-		
-		if (ignored["namespaces"]->isIgnored(GetFullNamespaceName(parent))) {
-			return;
-		}
+	auto* parent = d->getParent();
 
-		if(isIgnoredDecl(parent)) {
-			return;
-		}
+	// Ignored
+	auto srcLocation = sm->getPresumedLoc(d->getLocation());
+	if (caches.ignoredFiles.IsIgnored(srcLocation)) {
+		return;
+	}
+	
+	const auto& parentInfo = GetRecordInfo(parent);
+	if (parentInfo.ignoredNamespace) {
+		return;
+	}
 
-		if (!isStructureOrStructurePointerType(d->getType())) {
-			installFundamentalField(result);
-			return;
-		}
+	if(parentInfo.ignoredDecl) {
+		return;
+	}
 
-		if (parent->isClass() || parent->isStruct()) {
-			std::string parentName = GetFullStructureName(parent);
-			std::string typeName;
-			ID_T parentID = GetIDfromDecl(parent);
-			ID_T typeID = "";
-			if (d->getType()->isPointerType() || d->getType()->isReferenceType()) {
-				typeName = GetFullStructureName(d->getType()->getPointeeType()->getAsRecordDecl()); // CXX
-				typeID = GetIDfromDecl(d->getType()->getPointeeType()->getAsRecordDecl());			// CXX
-			}
-			else {
-				typeName = GetFullStructureName(d->getType()->getAsCXXRecordDecl());
-				typeID = GetIDfromDecl(d->getType()->getAsCXXRecordDecl());
-			}
-			//assert(parentID);
-			//assert(typeID);
+	if (!isStructureOrStructurePointerType(d->getType())) {
+		MineFundamentalField(d, parentInfo);
+		return;
+	}
 
-			Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
-			Structure* typeStructure = (Structure*)structuresTable.Lookup(typeID);
-			if (parentStructure->IsTemplateInstantiationSpecialization())		// insertion speciallization inherit its dependencies from the parent template
-				return;
-			if (!typeStructure)
-				typeStructure = (Structure*)structuresTable.Install(typeID, typeName);
+	if (parent->isClass() || parent->isStruct()) {
+		ID_T parentID = parentInfo.id;
+		const auto& typeName = caches.names.GetType(d->getType());
+		//assert(parentID);
+		//assert(typeName.id);
 
-			auto fieldID = GetIDfromDecl(d);
-			//assert(fieldID);
-			Definition field(fieldID, d->getQualifiedNameAsString(), parentStructure->GetNamespace(), typeStructure);
-			field.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
-			field.SetFullType(d->getType().getAsString());
-			auto* _field = parentStructure->InstallField(fieldID, field);
-			_field->SetAccessType((AccessType)d->getAccess());
-		}
+		Structure* parentStructure = (Structure*)table.Lookup(parentID);
+		Structure* typeStructure = (Structure*)table.Lookup(typeName.id);
+		if (parentStructure->IsTemplateInstantiationSpecialization())		// insertion speciallization inherit its dependencies from the parent template
+			return;
+		if (!typeStructure)
+			typeStructure = (Structure*)table.Install(typeName.id, typeName.name);
+
+		auto fieldID = GetIDfromDecl(d);
+		//assert(fieldID);
+		Definition field(fieldID, d->getQualifiedNameAsString(), parentStructure->GetNamespace(), typeStructure);
+		field.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+		field.SetFullType(d->getType().getAsString());
+		auto* _field = parentStructure->InstallField(fieldID, field);
+		_field->SetAccessType((AccessType)d->getAccess());
 	}
 }
 
@@ -375,192 +505,187 @@ void FeildDeclsCallback::run(const MatchFinder::MatchResult& result) {
 
 // Handle all the Methods
 void MethodDeclsCallback::run(const MatchFinder::MatchResult& result) {
+	tracing::Total total("MethodDeclsCallback");
 	if (const CXXMethodDecl* d = result.Nodes.getNodeAs<CXXMethodDecl>(METHOD_DECL)) {
-		const RecordDecl* parent = d->getParent();
-		std::string parentName = GetFullStructureName(parent);
-		auto parentID = GetIDfromDecl(parent);
-		auto methodID = GetIDfromDecl(d);
-		//assert(parentID);
-		//assert(methodID);
+		DeclMiner(table, mined, result.SourceManager, caches).MineMethod(d);
+	}
+}
 
+void DeclMiner::MineMethod(const CXXMethodDecl* d) {
+	if (!mined.Insert(d, *sm))
+		return;
 
-		if(!(d->isThisDeclarationADefinition())){
-			return;
-		}
+	const RecordDecl* parent = d->getParent();
 
-		// Ignored
-		auto srcLocation = result.SourceManager->getPresumedLoc(d->getLocation());
-		if (ignored["filePaths"]->isIgnored(srcLocation.getFilename())) {
-			return;
-		}
-		if (ignored["namespaces"]->isIgnored(GetFullNamespaceName(parent))) {
-			return;
-		}
+	if(!(d->isThisDeclarationADefinition())){
+		return;
+	}
 
-		if (isIgnoredDecl(parent)) {
-			return;
-		}
+	// Ignored
+	auto srcLocation = sm->getPresumedLoc(d->getLocation());
+	if (caches.ignoredFiles.IsIgnored(srcLocation)) {
+		return;
+	}
+	const auto& parentInfo = GetRecordInfo(parent);
+	if (parentInfo.ignoredNamespace) {
+		return;
+	}
 
-		Structure* parentStructure = (Structure*)structuresTable.Lookup(parentID);
-		assert(parentStructure);
-		/*if (!parentStructure) {
-			parentStructure = (Structure*)structuresTable.Install(parentID, parentName);
-		}*/
-		Method method(methodID, GetFullMethodName(d), parentStructure->GetNamespace());
-		method.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+	if (parentInfo.ignoredDecl) {
+		return;
+	}
 
-		// Method's Type
-		if (d->getDeclKind() == d->CXXConstructor) {
-			if (d->isTrivial()) {
-				method.SetMethodType(MethodType::Constructor_Trivial);
-			}
-			else {
-				method.SetMethodType(MethodType::Constructor_UserDefined);
-			}
+	const auto& methodName = caches.names.Get(d);
+	auto methodID = methodName.id;
+	//assert(methodID);
+	Structure* parentStructure = (Structure*)table.Lookup(parentInfo.id);
+	assert(parentStructure);
+	/*if (!parentStructure) {
+		parentStructure = (Structure*)table.Install(parentID, parentName);
+	}*/
+	Method method(methodID, methodName.name, parentStructure->GetNamespace());
+	method.SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+
+	// Method's Type
+	if (d->getDeclKind() == d->CXXConstructor) {
+		if (d->isTrivial()) {
+			method.SetMethodType(MethodType::Constructor_Trivial);
 		}
-		else if (d->getDeclKind() == d->CXXDestructor) {
-			if (d->isTrivial()) {
-				method.SetMethodType(MethodType::Destructor_Trivial);
-			}
-			else {
-				method.SetMethodType(MethodType::Destructor_UserDefined);
-			}
+		else {
+			method.SetMethodType(MethodType::Constructor_UserDefined);
 		}
-		else if (d->isOverloadedOperator()) {
-			if (d->isTrivial()) {
-				method.SetMethodType(MethodType::OverloadedOperator_Trivial);
-			}
-			else {
-				method.SetMethodType(MethodType::OverloadedOperator_UserDefined);
-			}
+	}
+	else if (d->getDeclKind() == d->CXXDestructor) {
+		if (d->isTrivial()) {
+			method.SetMethodType(MethodType::Destructor_Trivial);
 		}
-		else if (d->getTemplatedKind()) {
-			if (d->getTemplatedKind() == d->TK_FunctionTemplate) {
-				method.SetMethodType(MethodType::TemplateDefinition);
-			}
-			else if (d->getTemplatedKind() == d->TK_FunctionTemplateSpecialization || d->getTemplatedKind() == d->TK_DependentFunctionTemplateSpecialization) {
-				if (d->isTemplateInstantiation()) {
-					method.SetMethodType(MethodType::TemplateInstantiationSpecialization);
-				}
-				else {
-					method.SetMethodType(MethodType::TemplateFullSpecialization);
-				}
-			}
-			else if (d->getTemplatedKind() == d->TK_MemberSpecialization) {
-				method.SetMethodType(MethodType::UserMethod);		// user method on teplate class
-			}
-			else {
-				std::cout << d->getTemplatedKind() << "\n\n";
-				assert(0);
-			}
+		else {
+			method.SetMethodType(MethodType::Destructor_UserDefined);
+		}
+	}
+	else if (d->isOverloadedOperator()) {
+		if (d->isTrivial()) {
+			method.SetMethodType(MethodType::OverloadedOperator_Trivial);
 		}
 		else {
-			method.SetMethodType(MethodType::UserMethod);
-		}
-
-		//Template
-		if (method.IsTemplateFullSpecialization() || method.IsTemplateInstantiationSpecialization()) {
-		/*	// Tempalte Method's parent
-			Method* templateParentMethod = nullptr;
-			std::string parentMethodName = GetFullMethodName(d);
-			size_t start = parentMethodName.find("<");
-			size_t end = parentMethodName.find(">");
-			parentMethodName.erase(parentMethodName.begin() + start, parentMethodName.begin() + end + 1);
-			if (parentStructure->IsTemplateFullSpecialization() || parentStructure->IsTemplateInstantiationSpecialization()) {
-				
-				templateParentMethod = parentStructure->GetTemplateParent()->GetMethod(parentMethodName);
-			}
-			else {
-				templateParentMethod = parentStructure->GetMethod(parentMethodName);
-			}
-			assert(templateParentMethod);
-			method.SetTemplateParent(templateParentMethod);*/
-			//Template Arguments		
-			auto args = d->getTemplateSpecializationArgs()->asArray();
-			for (auto it : args) {
-				TemplateArgsVisit(it, [](TemplateArgument templateArg, Method* method) {
-					RecordDecl* d = nullptr;
-					if (templateArg.getKind() == TemplateArgument::Template) {
-						d = (RecordDecl*)templateArg.getAsTemplateOrTemplatePattern().getAsTemplateDecl()->getTemplatedDecl();
-						if (!d)													// a set of function templates 
-							return;
-					}
-					else if (templateArg.getKind() == TemplateArgument::Integral) {
-						return;
-					}
-					if (d || GetTemplateArgType(templateArg)->isStructureOrClassType()) {
-						if (!d)
-							d = GetTemplateArgType(templateArg)->getAsCXXRecordDecl();
-						std::string argStructName = GetFullStructureName(d);
-						auto argStructID = GetIDfromDecl(d);
-						//assert(argStructID);
-						Structure* argStruct = (Structure*)structuresTable.Lookup(argStructID);
-						if (argStruct == nullptr)
-							argStruct = (Structure*)structuresTable.Install(argStructID, argStructName);
-						method->InstallTemplateSpecializationArguments(argStructID, argStruct);
-					}
-					}, &method);
-			}
+			method.SetMethodType(MethodType::OverloadedOperator_UserDefined);
 		}
-
-		//Return
-		auto returnType = d->getReturnType();
-		if (isStructureOrStructurePointerType(returnType)) {
-			std::string typeName;
-			ID_T typeID;
-			if (returnType->isPointerType() || returnType->isReferenceType()) {
-				typeName = GetFullStructureName(returnType->getPointeeType()->getAsCXXRecordDecl());
-				typeID = GetIDfromDecl(returnType->getPointeeType()->getAsCXXRecordDecl());
+	}
+	else if (d->getTemplatedKind()) {
+		if (d->getTemplatedKind() == d->TK_FunctionTemplate) {
+			method.SetMethodType(MethodType::TemplateDefinition);
+		}
+		else if (d->getTemplatedKind() == d->TK_FunctionTemplateSpecialization || d->getTemplatedKind() == d->TK_DependentFunctionTemplateSpecialization) {
+			if (d->isTemplateInstantiation()) {
+				method.SetMethodType(MethodType::TemplateInstantiationSpecialization);
 			}
 			else {
-				typeName = GetFullStructureName(returnType->getAsCXXRecordDecl());
-				typeID = GetIDfromDecl(returnType->getAsCXXRecordDecl());
+				method.SetMethodType(MethodType::TemplateFullSpecialization);
 			}
-			//assert(typeID);
-			Structure* typeStructure = (Structure*)structuresTable.Lookup(typeID);
-			if (!typeStructure)
-				typeStructure = (Structure*)structuresTable.Install(typeID, typeName);
-			method.SetReturnType(typeStructure);
 		}
-
-		currentMethod = (Method*)parentStructure->InstallMethod(methodID, method);
-		sm = result.SourceManager;
-		
-		// Body - MemberExpr
-		auto* body = d->getBody();
-		if (body == nullptr) {
-			currentMethod = nullptr;
-			return;
+		else if (d->getTemplatedKind() == d->TK_MemberSpecialization) {
+			method.SetMethodType(MethodType::UserMethod);		// user method on teplate class
 		}
-		FindMemberExprVisitor visitor; 
-
-		literal_count = 0;
-		statement_count = 0;
-		branch_count = 0;
-		loop_count = 0;
-		scope_depth = -1;
-		scope_max_depth = 0;
+		else {
+			std::cout << d->getTemplatedKind() << "\n\n";
+			assert(0);
+		}
+	}
+	else {
+		method.SetMethodType(MethodType::UserMethod);
+	}
 
-		visitor.TraverseStmt(body);
-		
+	//Template
+	if (method.IsTemplateFullSpecialization() || method.IsTemplateInstantiationSpecialization()) {
+	/*	// Tempalte Method's parent
+		Method* templateParentMethod = nullptr;
+		std::string parentMethodName = GetFullMethodName(d);
+		size_t start = parentMethodName.find("<");
+		size_t end = parentMethodName.find(">");
+		parentMethodName.erase(parentMethodName.begin() + start, parentMethodName.begin() + end + 1);
+		if (parentStructure->IsTemplateFullSpecialization() || parentStructure->IsTemplateInstantiationSpecialization()) {
+			
+			templateParentMethod = parentStructure->GetTemplateParent()->GetMethod(parentMethodName);
+		}
+		else {
+			templateParentMethod = parentStructure->GetMethod(parentMethodName);
+		}
+		assert(templateParentMethod);
+		method.SetTemplateParent(templateParentMethod);*/
+		//Template Arguments		
+		auto args = d->getTemplateSpecializationArgs()->asArray();
+		for (auto it : args) {
+			TemplateArgsVisit(it, [](TemplateArgument templateArg, Method* method, SymbolTable* table, NamesCache* names) {
+				RecordDecl* d = nullptr;
+				if (templateArg.getKind() == TemplateArgument::Template) {
+					d = (RecordDecl*)templateArg.getAsTemplateOrTemplatePattern().getAsTemplateDecl()->getTemplatedDecl();
+					if (!d)													// a set of function templates 
+						return;
+				}
+				else if (templateArg.getKind() == TemplateArgument::Integral) {
+					return;
+				}
+				if (d || GetTemplateArgType(templateArg)->isStructureOrClassType()) {
+					if (!d)
+						d = GetTemplateArgType(templateArg)->getAsCXXRecordDecl();
+					const auto& argStruct = names->Get(d);
+					//assert(argStruct.id);
+					Structure* argStructure = (Structure*)table->Lookup(argStruct.id);
+					if (argStructure == nullptr)
+						argStructure = (Structure*)table->Install(argStruct.id, argStruct.name);
+					method->InstallTemplateSpecializationArguments(argStruct.id, argStructure);
+				}
+				}, &method, &table, &caches.names);
+		}
+	}
 
-		//std::cout << d->getAccess() << std::endl;
-		currentMethod->SetAccessType((AccessType)d->getAccess());
-		currentMethod->SetLiterals(literal_count);
-		currentMethod->SetStatements(statement_count);
-		currentMethod->SetBranches(branch_count);
-		currentMethod->SetLoops(loop_count);
-		currentMethod->SetMaxScopeDepth(scope_max_depth);
-		currentMethod->SetLineCount(sm->getExpansionLineNumber(body->getEndLoc()) - sm->getExpansionLineNumber(body->getBeginLoc()));
-		currentMethod->SetVirtual(d->isVirtual());
-		currentMethod = nullptr;
+	//Return
+	auto returnType = d->getReturnType();
+	if (isStructureOrStructurePointerType(returnType)) {
+		const auto& typeName = caches.names.GetType(returnType);
+		//assert(typeName.id);
+		Structure* typeStructure = (Structure*)table.Lookup(typeName.id);
+		if (!typeStructure)
+			typeStructure = (Structure*)table.Install(typeName.id, typeName.name);
+		method.SetReturnType(typeStructure);
+	}
 
-		
+	auto* currentMethod = (Method*)parentStructure->InstallMethod(methodID, method);
+	
+	// Body - MemberExpr
+	auto* body = d->getBody();
+	if (body == nullptr) {
+		if (d->hasSkippedBody()) {									// not parsed (MiningDepth::Signatures), no body metrics
+			currentMethod->SetAccessType((AccessType)d->getAccess());
+			currentMethod->SetVirtual(d->isVirtual());
+		}
+		return;
 	}
+	// A body is mined once per table (by its first TU, e.g. of a template specialization), as the tables are merged: first wins
+	if (currentMethod->IsBodyMined())
+		return;
+	MethodDeclsCallback::FindMemberExprVisitor visitor(currentMethod, sm, &table, &caches.names); 
+	visitor.TraverseStmt(body);
+	const auto& context = visitor.GetContext();
+
+	//std::cout << d->getAccess() << std::endl;
+	currentMethod->SetAccessType((AccessType)d->getAccess());
+	currentMethod->SetLiterals(context.literal_count);
+	currentMethod->SetStatements(context.statement_count);
+	currentMethod->SetBranches(context.branch_count);
+	currentMethod->SetLoops(context.loop_count);
+	currentMethod->SetMaxScopeDepth(context.scope_max_depth);
+	currentMethod->SetLineCount(sm->getExpansionLineNumber(body->getEndLoc()) - sm->getExpansionLineNumber(body->getBeginLoc()));
+	currentMethod->SetVirtual(d->isVirtual());
+	currentMethod->SetBodyMined(true);
 }
 
 // ----------------------------------------------------------------------------------------------
 
+const MethodDeclsCallback::TraversalContext& MethodDeclsCallback::FindMemberExprVisitor::GetContext() const {
+	return context;
+}
+
 bool MethodDeclsCallback::FindMemberExprVisitor::TraverseStmt(Stmt* stmt) {
 	if (!stmt)
 		return true;
@@ -569,10 +694,10 @@ bool MethodDeclsCallback::FindMemberExprVisitor::TraverseStmt(Stmt* stmt) {
 
 	switch (stmt->getStmtClass()) {
 		case Stmt::StmtClass::CompoundStmtClass:
-			MethodDeclsCallback::statement_count += std::distance(stmt->child_begin(), stmt->child_end());
-			scope_depth++;
-			if (scope_max_depth < scope_depth)
-				scope_max_depth = scope_depth;
+			context.statement_count += std::distance(stmt->child_begin(), stmt->child_end());
+			context.scope_depth++;
+			if (context.scope_max_depth < context.scope_depth)
+				context.scope_max_depth = context.scope_depth;
 			break;
 
 		case Stmt::StmtClass::IfStmtClass:
@@ -581,12 +706,12 @@ bool MethodDeclsCallback::FindMemberExprVisitor::TraverseStmt(Stmt* stmt) {
 		case Stmt::StmtClass::ContinueStmtClass:
 		case Stmt::StmtClass::GotoStmtClass:
 		case Stmt::StmtClass::ReturnStmtClass:
-			MethodDeclsCallback::branch_count++;
+			context.branch_count++;
 			break;
 	
 		case Stmt::StmtClass::ForStmtClass:
 		case Stmt::StmtClass::WhileStmtClass:
-			MethodDeclsCallback::loop_count++;
+			context.loop_count++;
 			break;
 		/*case Stmt::StmtClass::CStyleCastExprClass: {
 			std::cout << ((CStyleCastExpr*)stmt)->getType().getAsString() << std::endl;
@@ -601,12 +726,12 @@ bool MethodDeclsCallback::FindMemberExprVisitor::TraverseStmt(Stmt* stmt) {
 
 		default: {
 			if (class_name.find("Literal") != std::string::npos)
-				MethodDeclsCallback::literal_count++;
+				context.literal_count++;
 		}
 	}
 	RecursiveASTVisitor<FindMemberExprVisitor>::TraverseStmt(stmt);
 	if (stmt->getStmtClass() == Stmt::StmtClass::CompoundStmtClass)
-		scope_depth--;
+		context.scope_depth--;
 	return true;
 }
 
@@ -646,35 +771,26 @@ bool MethodDeclsCallback::FindMemberExprVisitor::VisitMemberExpr(MemberExpr* mem
 			
 		auto baseType = base->getType();
 		auto baseRange = base->getSourceRange();
-		auto baseScLocationBegin = MethodDeclsCallback::sm->getPresumedLoc(baseRange.getBegin());
-		auto baseScLocationEnd = MethodDeclsCallback::sm->getPresumedLoc(baseRange.getEnd());
+		auto baseScLocationBegin = context.sm->getPresumedLoc(baseRange.getBegin());
+		auto baseScLocationEnd = context.sm->getPresumedLoc(baseRange.getEnd());
 		SourceInfo baseLocBegin(baseScLocationBegin.getFilename(), baseScLocationBegin.getLine(), baseScLocationBegin.getColumn());
 		SourceInfo baseLocEnd(baseScLocationEnd.getFilename(), baseScLocationEnd.getLine(), baseScLocationEnd.getColumn());
 		std::string exprString = str; 
 		Method::MemberExpr methodMemberExpr("__DUMMY EXPR__", baseLocEnd, baseLocBegin.GetFileName(), baseLocBegin.GetLine(), baseLocBegin.GetColumn());
 			
-		std::string typeName;
-		ID_T typeID;
-		if (baseType->isPointerType() || baseType->isReferenceType()) {
-			typeName = GetFullStructureName(baseType->getPointeeType()->getAsCXXRecordDecl());
-			typeID = GetIDfromDecl(baseType->getPointeeType()->getAsCXXRecordDecl());
-		}
-		else {
-			typeName = GetFullStructureName(baseType->getAsCXXRecordDecl());
-			typeID = GetIDfromDecl(baseType->getAsCXXRecordDecl());
-		}
-		Structure* typeStructure = (Structure*)structuresTable.Lookup(typeID);
+		const auto& typeName = context.names->GetType(baseType);
+		Structure* typeStructure = (Structure*)context.table->Lookup(typeName.id);
 		if (!typeStructure)
-			typeStructure = (Structure*)structuresTable.Install(typeID, typeName);
+			typeStructure = (Structure*)context.table->Install(typeName.id, typeName.name);
 
 		Method::Member member(str, typeStructure, baseLocEnd, memType);
-		MethodDeclsCallback::currentMethod->InsertMemberExpr(methodMemberExpr, member, baseLocBegin.toString());
+		context.method->InsertMemberExpr(methodMemberExpr, member, baseLocBegin.toString());
 		
 	}
 		
 	auto range = memberExpr->getSourceRange();
-	auto srcLocationBegin = MethodDeclsCallback::sm->getPresumedLoc(range.getBegin());
-	auto srcLocationEnd = MethodDeclsCallback::sm->getPresumedLoc(range.getEnd());
+	auto srcLocationBegin = context.sm->getPresumedLoc(range.getBegin());
+	auto srcLocationEnd = context.sm->getPresumedLoc(range.getEnd());
 	SourceInfo locBegin(srcLocationBegin.getFilename(), srcLocationBegin.getLine(), srcLocationBegin.getColumn());
 	SourceInfo locEnd(srcLocationEnd.getFilename(), srcLocationEnd.getLine(), srcLocationEnd.getColumn());
 	std::string exprString;
@@ -699,19 +815,19 @@ bool MethodDeclsCallback::FindMemberExprVisitor::VisitMemberExpr(MemberExpr* mem
 	//}
 
 	Method::MemberExpr methodMemberExpr(exprString, locEnd, locBegin.GetFileName(), locBegin.GetLine(), locBegin.GetColumn());
-	MethodDeclsCallback::currentMethod->UpdateMemberExpr(methodMemberExpr, locBegin.toString());
+	context.method->UpdateMemberExpr(methodMemberExpr, locBegin.toString());
 
 	/*if (!isStructureOrStructurePointerType(type)) {
 		if (decl->getKind() == decl->CXXMethod) {
 			CXXMethodDecl* methodDecl = (CXXMethodDecl*)decl;
 			type = methodDecl->getReturnType();
 			//if (!isStructureOrStructurePointerType(type)) {
-				MethodDeclsCallback::currentMethod->UpdateMemberExpr(methodMemberExpr, locBegin.toString());	// to get the full expr if I have fields with not a class type
+				context.method->UpdateMemberExpr(methodMemberExpr, locBegin.toString());	// to get the full expr if I have fields with not a class type
 				return true;
 			//}
 		}
 		else {
-			MethodDeclsCallback::currentMethod->UpdateMemberExpr(methodMemberExpr, locBegin.toString());
+			context.method->UpdateMemberExpr(methodMemberExpr, locBegin.toString());
 			return true;
 		}
 	}
@@ -733,96 +849,90 @@ bool MethodDeclsCallback::FindMemberExprVisitor::VisitMemberExpr(MemberExpr* mem
 
 	Method::Member member(decl->getNameAsString(), typeStructure, locEnd, Value_mem_t);
 
-	MethodDeclsCallback::currentMethod->InsertMemberExpr(methodMemberExpr, member, locBegin.toString());*/
+	context.method->InsertMemberExpr(methodMemberExpr, member, locBegin.toString());*/
 
 	return true;
 }
 
 // ----------------------------------------------------------------------------------------------
 
-// Handle Method's Vars and Args
 void MethodVarsCallback::run(const MatchFinder::MatchResult& result) {
+	tracing::Total total("MethodVarsCallback");
 	if (const VarDecl* d = result.Nodes.getNodeAs<VarDecl>(METHOD_VAR_OR_ARG)) {
-		auto* parentMethodDecl = d->getParentFunctionOrMethod();
+		DeclMiner(table, mined, result.SourceManager, caches).MineMethodVar(d);
+	}
+}
 
-		// Ignore the methods declarations 
-		if (!parentMethodDecl || !(((CXXMethodDecl*)parentMethodDecl)->isThisDeclarationADefinition())) {
-			return;
-		}
+// Handle Method's Vars and Args
+void DeclMiner::MineMethodVar(const VarDecl* d) {
+	if (!mined.Insert(d, *sm))
+		return;
 
-		if (d->isLocalVarDeclOrParm() && parentMethodDecl->getDeclKind() == d->CXXMethod) {	// including params
-		//if(d->isFunctionOrMethodVarDecl() && parentMethod->getDeclKind() == d->CXXMethod){		// excluding params	- d->isFunctionOrMethodVarDecl()-> like isLocalVarDecl() but excludes variables declared in blocks?.		
-			auto* parentClass = (CXXRecordDecl*)parentMethodDecl->getParent();
+	auto* parentMethodDecl = d->getParentFunctionOrMethod();
 
-			if (isIgnoredDecl(parentClass)) {
-				return;
-			}
+	// Ignore the methods declarations 
+	if (!parentMethodDecl || !(((CXXMethodDecl*)parentMethodDecl)->isThisDeclarationADefinition())) {
+		return;
+	}
 
-			auto srcLocation = result.SourceManager->getPresumedLoc(d->getLocation());
-			if (ignored["filePaths"]->isIgnored(srcLocation.getFilename())) {
-				return;
-			}
-			if (ignored["namespaces"]->isIgnored(GetFullNamespaceName(parentClass))) {
-				return;
-			}
-			
-			auto parentClassName = GetFullStructureName(parentClass);
-			auto parentMethodName = GetFullMethodName((CXXMethodDecl*)parentMethodDecl);
-			auto parentClassID = GetIDfromDecl(parentClass);
-			auto parentMethodID = GetIDfromDecl((CXXMethodDecl*)parentMethodDecl);
-			//assert(parentClassID);
-			//assert(parentMethodID);
-			Structure* parentStructure = (Structure*)structuresTable.Lookup(parentClassID);
-			Method* parentMethod = (Method*)parentStructure->LookupMethod(parentMethodID);
-			//assert(parentMethod);
-			
-			// remove from TemplateInstantiationSpecialization methods the decletarions and arguments 
-			//if (parentMethod->isTemplateInstantiationSpecialization()) {
-			//	return;
-			//}
+	if (d->isLocalVarDeclOrParm() && parentMethodDecl->getDeclKind() == d->CXXMethod) {	// including params
+	//if(d->isFunctionOrMethodVarDecl() && parentMethod->getDeclKind() == d->CXXMethod){		// excluding params	- d->isFunctionOrMethodVarDecl()-> like isLocalVarDecl() but excludes variables declared in blocks?.		
+		auto* parentClass = (CXXRecordDecl*)parentMethodDecl->getParent();
 
-			std::string typeName;
-			ID_T typeID;
-			auto defID = GetIDfromDecl(d);
-			Definition* def = nullptr;
+		auto srcLocation = sm->getPresumedLoc(d->getLocation());
+		if (caches.ignoredFiles.IsIgnored(srcLocation)) {
+			return;
+		}
+		const auto& parentInfo = GetRecordInfo(parentClass);
+		if (parentInfo.ignoredDecl || parentInfo.ignoredNamespace) {
+			return;
+		}
+		
+		auto parentClassID = parentInfo.id;
+		auto parentMethodID = caches.names.Get((CXXMethodDecl*)parentMethodDecl).id;
+		//assert(parentClassID);
+		//assert(parentMethodID);
+		Structure* parentStructure = (Structure*)table.Lookup(parentClassID);
+		Method* parentMethod = (Method*)parentStructure->LookupMethod(parentMethodID);
+		//assert(parentMethod);
+		
+		// remove from TemplateInstantiationSpecialization methods the decletarions and arguments 
+		//if (parentMethod->isTemplateInstantiationSpecialization()) {
+		//	return;
+		//}
 
-			if (isStructureOrStructurePointerType(d->getType())) {
-				if (d->getType()->isPointerType() || d->getType()->isReferenceType()) {
-					typeName = GetFullStructureName(d->getType()->getPointeeType()->getAsCXXRecordDecl());
-					typeID = GetIDfromDecl(d->getType()->getPointeeType()->getAsCXXRecordDecl());
-				}
-				else {
-					typeName = GetFullStructureName(d->getType()->getAsCXXRecordDecl());
-					typeID = GetIDfromDecl(d->getType()->getAsCXXRecordDecl());
-				}
-				//assert(typeID);
-				Structure* typeStructure = (Structure*)structuresTable.Lookup(typeID);
-				if (!typeStructure)
-					typeStructure = (Structure*)structuresTable.Install(typeID, typeName);
-				//assert(defID);
-				def = new Definition (defID, d->getQualifiedNameAsString(), parentMethod->GetNamespace(), typeStructure);
-				def->SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
-			}
-			else {
+		auto defID = GetIDfromDecl(d);
+		Definition* def = nullptr;
 
-				typeName = d->getType().getAsString();
-				def = new Definition (defID, d->getQualifiedNameAsString(), parentStructure->GetNamespace());
-				def->SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
-				def->SetFullType(typeName);
-			}
+		if (isStructureOrStructurePointerType(d->getType())) {
+			const auto& typeName = caches.names.GetType(d->getType());
+			//assert(typeName.id);
+			Structure* typeStructure = (Structure*)table.Lookup(typeName.id);
+			if (!typeStructure)
+				typeStructure = (Structure*)table.Install(typeName.id, typeName.name);
+			//assert(defID);
+			def = new Definition (defID, d->getQualifiedNameAsString(), parentMethod->GetNamespace(), typeStructure);
+			def->SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+		}
+		else {
 
+			std::string typeName = d->getType().getAsString();
+			def = new Definition (defID, d->getQualifiedNameAsString(), parentStructure->GetNamespace());
+			def->SetSourceInfo(srcLocation.getFilename(), srcLocation.getLine(), srcLocation.getColumn());
+			def->SetFullType(typeName);
+		}
 
-			
-			
-			if (d->isLocalVarDecl()) {
-				parentMethod->InstallDefinition(defID, *def);
-			}
-			else {
-				parentMethod->InstallArg(defID, *def);
-			}
 
-			delete def;
+		
+		
+		if (d->isLocalVarDecl()) {
+			parentMethod->InstallDefinition(defID, *def);
+		}
+		else {
+			parentMethod->InstallArg(defID, *def);
 		}
+
+		delete def;
 	}
 }
 
@@ -857,21 +967,38 @@ static inline bool hasEnding(std::string const& str, std::string const& ending)
 	return false;
 }
 
+/*
+	Fills paths with the files the ClangTool has opened (sources and their transitive includes)
+*/
+static void CollectFiles(ClangTool* Tool, std::vector<std::string>& paths) {
+	auto& file_manager = Tool->getFiles();
+	SmallVector<const FileEntry* > files;
+	file_manager.GetUniqueIDMapping(files);
+	for (auto file : files) {
+		paths.push_back(file->getName().str());
+	}
+}
+
 /*
 	Clears srcs and headers vectors.
 	Fills srcs and headers vectors with paths extracted from the ClangTool
 */
 void dependenciesMining::SetFiles(ClangTool* Tool, std::vector<std::string>& srcs, std::vector<std::string>& headers) {
+	std::vector<std::string> paths;
+	CollectFiles(Tool, paths);
+	SetFiles(paths, srcs, headers);
+}
+
+/*
+	Clears srcs and headers vectors.
+	Fills srcs and headers vectors with the non ignored paths
+*/
+void dependenciesMining::SetFiles(const std::vector<std::string>& paths, std::vector<std::string>& srcs, std::vector<std::string>& headers) {
 	srcs.clear();
 	headers.clear();
 
-	std::string path;
-	auto& file_manager = Tool->getFiles();
-	SmallVector<const FileEntry* > files;
-	file_manager.GetUniqueIDMapping(files);
-	for (auto file : files) {
-		path = file->getName().str();
-		if (ignored["filePaths"]->isIgnored(path))
+	for (const auto& path : paths) {
+		if (ignored.at("filePaths")->isIgnored(path))
 			continue;
 
 		if (hasEnding(path, ".h")) {
@@ -887,56 +1014,389 @@ void dependenciesMining::SetFiles(ClangTool* Tool, std::vector<std::string>& src
 }
 
 /*
-	Clang Tool Creation
+	Mining Engines
 */
-static llvm::cl::OptionCategory MyToolCategory("my-tool options");
-static llvm::cl::extrahelp CommonHelp(CommonOptionsParser::HelpMessage);
-static llvm::cl::extrahelp MoreHelp("\nA help message for this specific tool can be added afterwards..\n");
 
-int dependenciesMining::CreateClangTool(const char* cmpDBPath, std::vector<std::string>& srcs, std::vector<std::string>& headers, const char* ignoredFilePaths, const char* ignoredNamespaces) {
-	ClangTool* Tool;
-	std::unique_ptr<CompilationDatabase> cmpDB;
-	//CommonOptionsParser *OptionsParser = nullptr;
+// The matchers with their callbacks, bound to the SymbolTable they fill
+struct Matchers {
+	TranslationUnitCaches caches;
+	ClassDeclsCallback classCallback;
+	FeildDeclsCallback fieldCallback;
+	MethodDeclsCallback methodCallback;
+	MethodVarsCallback methodVarCallback;
+	MatchFinder finder;
+
+	// MiningDepth::Structure: only the class and field matchers
+	Matchers(SymbolTable& table, MinedDecls& mined, MiningDepth depth) : classCallback(table, mined, caches), fieldCallback(table, mined, caches), methodCallback(table, mined, caches), methodVarCallback(table, mined, caches) {
+		finder.addMatcher(ClassDeclMatcher, &classCallback);
+		finder.addMatcher(FieldDeclMatcher, &fieldCallback);
+		if (depth != MiningDepth::Structure) {
+			finder.addMatcher(MethodDeclMatcher, &methodCallback);
+			finder.addMatcher(MethodVarMatcher, &methodVarCallback);
+		}
+	}
+};
 
-	if (cmpDBPath == nullptr) {
-		int argc = 3;
-		const char* argv[3];
-		argv[0] = "";
-		argv[1] = "";
-		argv[2] = "--";
+/*
+	Forwards the TU to the consumer of the engine. Tells the parser which function bodies to skip: 
+	all of them (MiningDepth::Signatures and Structure, no body is mined) or the ones located in ignored files 
+	(skipIgnoredBodies, the engines do not mine them).
+	Sema still parses the bodies it cannot skip (constexpr functions, deduced return types).
+*/
+class SkipFunctionBodiesConsumer : public MultiplexConsumer {
+	SourceManager& sm;
+	bool skipAll;
+	IgnoredFileIDs ignoredFiles;
+public:
+	SkipFunctionBodiesConsumer(SourceManager& sm, bool skipAll, std::vector<std::unique_ptr<ASTConsumer>> consumers) : MultiplexConsumer(std::move(consumers)), sm(sm), skipAll(skipAll) {};
+
+	bool shouldSkipFunctionBody(Decl* d) override {
+		if (skipAll)
+			return true;
+		auto srcLocation = sm.getPresumedLoc(d->getLocation());
+		return srcLocation.isValid() && ignoredFiles.IsIgnored(srcLocation);
+	}
+};
+
+class SkipFunctionBodiesAction : public WrapperFrontendAction {
+	bool skipAll;
+public:
+	SkipFunctionBodiesAction(std::unique_ptr<FrontendAction> action, bool skipAll) : WrapperFrontendAction(std::move(action)), skipAll(skipAll) {};
+
+protected:
+	std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& compiler, StringRef file) override {
+		auto consumer = WrapperFrontendAction::CreateASTConsumer(compiler, file);
+		if (!consumer)
+			return nullptr;
+		compiler.getFrontendOpts().SkipFunctionBodies = true;			// read by the parser, which then asks the consumer per body
+		std::vector<std::unique_ptr<ASTConsumer>> consumers;
+		consumers.push_back(std::move(consumer));
+		return std::make_unique<SkipFunctionBodiesConsumer>(compiler.getSourceManager(), skipAll, std::move(consumers));
+	}
+};
+
+// Traces the TU, from the start of its preprocessing to the end of the action
+class TracedAction : public WrapperFrontendAction {
+	std::optional<tracing::Scope> scope;
+public:
+	TracedAction(std::unique_ptr<FrontendAction> action) : WrapperFrontendAction(std::move(action)) {};
+
+protected:
+	bool BeginSourceFileAction(CompilerInstance& compiler) override {
+		scope.emplace(tracing::Category::TranslationUnit, getCurrentFile().str());
+		return WrapperFrontendAction::BeginSourceFileAction(compiler);
+	}
+
+	void EndSourceFileAction() override {
+		WrapperFrontendAction::EndSourceFileAction();
+		scope.reset();
+	}
+};
+
+static bool SkipsFunctionBodies(const MiningOptions& options) {
+	return options.skipIgnoredBodies || options.depth != MiningDepth::Full;
+}
+
+// The decls mined by the TUs the factory creates actions for are skipped by the next ones
+class MiningActionFactory : public FrontendActionFactory {
+	MiningOptions options;
+	SymbolTable& table;
+	MinedDecls mined;
+	std::unique_ptr<Matchers> matchers;
+	std::unique_ptr<FrontendActionFactory> matchersActionFactory;
+public:
+	MiningActionFactory(const MiningOptions& options, SymbolTable& table) : options(options), table(table) {
+		if (options.engine == MiningEngine::Matchers) {
+			matchers = std::make_unique<Matchers>(table, mined, options.depth);
+			matchersActionFactory = newFrontendActionFactory(&matchers->finder);
+		}
+	}
+
+	std::unique_ptr<FrontendAction> create() override {
+		std::unique_ptr<FrontendAction> action;
+		if (options.engine == MiningEngine::SinglePass)
+			action = std::make_unique<SinglePassAction>(table, mined, options.depth);
+		else
+			action = matchersActionFactory->create();
+		if (SkipsFunctionBodies(options))
+			action = std::make_unique<SkipFunctionBodiesAction>(std::move(action), options.depth != MiningDepth::Full);
+		if (tracing::IsEnabled())
+			action = std::make_unique<TracedAction>(std::move(action));
+		return action;
+	}
+};
+
+std::unique_ptr<FrontendActionFactory> dependenciesMining::NewMiningActionFactory(const MiningOptions& options, SymbolTable& table) {
+	return std::make_unique<MiningActionFactory>(options, table);
+}
+
+
+/*
+	Mining Workers
+*/
+
+// returns true only if str starts with start
+static inline bool hasStart(std::string const& str, std::string const& start) {
+	return str.compare(0, start.length(), start) == 0;
+}
+
+static bool IsCodeGenFlag(const std::string& arg) {
+	if (hasStart(arg, "-g"))
+		return arg != "-gcc-toolchain";											// debug info (-g, -g3, -ggdb, -gdwarf-4, ...)
+	return arg == "-ffunction-sections" || arg == "-fdata-sections" || arg == "-pipe"
+		|| arg == "-fomit-frame-pointer" || arg == "-fno-omit-frame-pointer" || arg == "--coverage" || arg == "-fcoverage-mapping"
+		|| hasStart(arg, "-flto") || hasStart(arg, "-fprofile-") || hasStart(arg, "-fstack-protector")
+		|| hasStart(arg, "-save-temps") || hasStart(arg, "-Wl,") || hasStart(arg, "-Wa,");
+}
+
+/*
+	Removes the single token flags that only affect code generation (debug info, sections, LTO, profiling, linker and 
+	assembler options), they do not change the parsed code. Flags that define macros (-O, -fPIC, -march, sanitizers) are kept.
+*/
+static ArgumentsAdjuster GetStripCodeGenAdjuster() {
+	return [](const CommandLineArguments& args, StringRef file) {
+		CommandLineArguments adjusted;
+		for (size_t i = 0; i < args.size(); ++i) {
+			if (i == 0 || !IsCodeGenFlag(args[i]))								// args[0]: the compiler
+				adjusted.push_back(args[i]);
+		}
+		return adjusted;
+	};
+}
+
+static void AdjustArguments(ClangTool& tool, const MiningOptions& options) {
+	if (SkipsFunctionBodies(options))
+		tool.appendArgumentsAdjuster(GetStripCodeGenAdjuster());
+}
+
+// Mines files (serially) into table
+static int RunTool(const CompilationDatabase& cmpDB, const std::vector<std::string>& files, const MiningOptions& options, SymbolTable& table, std::vector<std::string>& visitedFiles) {
+	ClangTool tool(cmpDB, files);
+	AdjustArguments(tool, options);
+	int result = tool.run(NewMiningActionFactory(options, table).get());
+
+	CollectFiles(&tool, visitedFiles);
+	return result;
+}
+
+// Mines a single TU, with its own file system (ClangTool changes the working directory per compile command)
+static int RunTool(const CompilationDatabase& cmpDB, const std::string& file, const MiningOptions& options, FrontendActionFactory* actionFactory, std::vector<std::string>& visitedFiles) {
+	IntrusiveRefCntPtr<llvm::vfs::FileSystem> fs = llvm::vfs::createPhysicalFileSystem();
+	ClangTool tool(cmpDB, { file }, std::make_shared<PCHContainerOperations>(), fs);
+	AdjustArguments(tool, options);
+	int result = tool.run(actionFactory);
+	CollectFiles(&tool, visitedFiles);
+	return result;
+}
+
+/*
+	Mines a TU into its own table, with a cache: up to date TUs are loaded from it instead (hit).
+	Failed TUs are not cached.
+*/
+static int MineTranslationUnit(const CompilationDatabase& cmpDB, const std::string& file, const MiningOptions& options, MiningCache& cache, SymbolTable& table, std::vector<std::string>& visitedFiles, bool& hit) {
+	auto commands = cmpDB.getCompileCommands(file);
+	hit = cache.Load(file, commands, table, visitedFiles);
+	if (hit)
+		return 0;
+
+	int result = RunTool(cmpDB, file, options, NewMiningActionFactory(options, table).get(), visitedFiles);
+	if (!result)
+		cache.Store(file, commands, table, visitedFiles);
+	return result;
+}
 
-		auto OptionsParser = CommonOptionsParser::create(argc, argv, MyToolCategory);
-		//OptionsParser = new CommonOptionsParser(argc, argv, MyToolCategory);
+/*
+	Spreads the TUs over jobs worker threads. Each TU is mined into its own SymbolTable, merged into
+	structuresTable in the order of files as soon as all the TUs before it are: the definitions that win
+	are the ones a serial run keeps, whatever the scheduling.
+	The TUs are dispatched longest first (by the timings of the previous runs), the timings are updated
+	with the TUs mined (not loaded from the cache). Once 2 * jobs tables wait for a TU before them, the workers
+	mine that TU if nobody does, or wait for it to be merged: at most 3 * jobs tables are kept.
+	visitedFiles keeps the order a serial run would have: TU by TU, first appearance wins.
+*/
+static int RunWorkers(const CompilationDatabase& cmpDB, const std::vector<std::string>& files, unsigned jobs, const MiningOptions& options, MiningCache* cache, TUTimings& timings, std::vector<std::string>& visitedFiles) {
+	std::vector<std::unique_ptr<SymbolTable>> tables(files.size());		// mined, not merged yet
+	std::vector<std::vector<std::string>> visitedPerTU(files.size());
+	std::vector<double> durations(files.size(), -1);				// ms, -1: not mined
+	auto order = timings.GetLongestFirstOrder(files);
+	std::atomic<size_t> cacheHits{ 0 };
+	std::atomic<int> result{ 0 };
+	std::mutex mutex;												// the claims and the merge
+	std::condition_variable progress;								// merged advanced
+	std::vector<char> claimed(files.size(), 0);
+	size_t nextLongest = 0;											// in order
+	size_t firstUnclaimed = 0;										// in files
+	size_t merged = 0;												// files[0 .. merged) are in structuresTable
+	size_t waiting = 0;												// tables mined, not merged yet
+	const size_t maxWaiting = 2 * (size_t)jobs;
+
+	const size_t blocked = files.size() + 1;
+
+	// Under mutex: the TU to mine next, files.size() once all are claimed. Once maxWaiting tables wait, only files[merged]
+	// (the TU the merge waits for) is claimed, blocked if it is being mined
+	auto claim = [&]() {
+		size_t tu = files.size();
+		if (waiting >= maxWaiting) {
+			while (firstUnclaimed < files.size() && claimed[firstUnclaimed])
+				++firstUnclaimed;
+			if (firstUnclaimed == files.size())
+				return tu;
+			if (firstUnclaimed != merged)
+				return blocked;
+			tu = firstUnclaimed;
+		}
+		else {
+			while (nextLongest < order.size() && claimed[order[nextLongest]])
+				++nextLongest;
+			if (nextLongest < order.size())
+				tu = order[nextLongest];
+		}
+		if (tu < files.size())
+			claimed[tu] = 1;
+		return tu;
+	};
+
+	std::vector<std::thread> workers;
+	for (unsigned w = 0; w < jobs; ++w) {
+		workers.emplace_back([&]() {
+			for (;;) {
+				size_t tu;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					while ((tu = claim()) == blocked)
+						progress.wait(lock);
+				}
+				if (tu == files.size())
+					break;
+				auto table = std::make_unique<SymbolTable>();
+				auto start = std::chrono::steady_clock::now();
+				int tuResult;
+				bool hit = false;
+				if (cache)
+					tuResult = MineTranslationUnit(cmpDB, files[tu], options, *cache, *table, visitedPerTU[tu], hit);
+				else 
+					tuResult = RunTool(cmpDB, files[tu], options, NewMiningActionFactory(options, *table).get(), visitedPerTU[tu]);
+				if (hit)
+					++cacheHits;
+				else
+					durations[tu] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				if (tuResult)
+					result = tuResult;
+
+				std::lock_guard<std::mutex> lock(mutex);
+				tables[tu] = std::move(table);
+				++waiting;
+				for (; merged < files.size() && tables[merged]; ++merged) {
+					structuresTable.Merge(*tables[merged]);
+					tables[merged].reset();
+					--waiting;
+					progress.notify_all();
+				}
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	for (size_t tu = 0; tu < files.size(); ++tu) {
+		if (durations[tu] >= 0)
+			timings.Set(files[tu], durations[tu]);
+	}
 
-		Tool = new ClangTool(OptionsParser->getCompilations(), srcs);
+	std::unordered_set<std::string> seen;
+	for (const auto& tuFiles : visitedPerTU) {
+		for (const auto& path : tuFiles) {
+			if (seen.insert(path).second)
+				visitedFiles.push_back(path);
+		}
+	}
+	if (cache)
+		std::cout << "Mining cache: " << cacheHits << "/" << files.size() << " translation units up to date\n";
+	return result;
+}
+
+// The options that change what a TU contributes, entries mined with other settings are not reused
+static std::string GetCacheSettings(const MiningOptions& options) {
+	std::string settings;
+	if (options.depth == MiningDepth::Signatures)
+		settings += "depth=signatures;";
+	else if (options.depth == MiningDepth::Structure)
+		settings += "depth=structure;";
+	if (options.skipIgnoredBodies)
+		settings += "skip-ignored-bodies;";
+	return settings;
+}
+
+/*
+	The TUs of a shard: every count-th of the files sorted by path, from the index-th on.
+	The same on every agent that mines a shard (for the same compilation database).
+*/
+static std::vector<std::string> SelectShard(std::vector<std::string> files, unsigned index, unsigned count) {
+	std::sort(files.begin(), files.end());
+	std::vector<std::string> shard;
+	for (size_t i = index; i < files.size(); i += count)
+		shard.push_back(files[i]);
+	return shard;
+}
+
+/*
+	Clang Tool Creation
+	options.jobs: number of worker threads (0: one per hardware thread, 1: serial run)
+	options.cacheDir: incremental mining cache (unchanged TUs are not parsed again)
+	options.engine: matchers or single pass visitor
+	options.skipIgnoredBodies: the function bodies of the ignored files are not parsed, the code generation flags are stripped
+	options.depth: everything, the signatures (no function bodies parsed) or the structures only (no methods either)
+	options.timingsPath: per TU mining durations, the parallel runs dispatch the TUs longest first by them and update them
+	options.shardIndex / shardCount: only the TUs of a shard are mined
+*/
+int dependenciesMining::CreateClangTool(const char* cmpDBPath, std::vector<std::string>& srcs, std::vector<std::string>& headers, const char* ignoredFilePaths, const char* ignoredNamespaces, const MiningOptions& options) {
+	std::unique_ptr<CompilationDatabase> cmpDB;
+	std::vector<std::string> files;
+
+	if (cmpDBPath == nullptr) {
+		// same as parsing the command line "--": no extra compilation flags
+		cmpDB = std::make_unique<FixedCompilationDatabase>(".", std::vector<std::string>());
+		files = srcs;
 	}
 	else {
 		cmpDB = LoadCompilationDatabase(cmpDBPath);
 		if (!cmpDB)
 			return -1;
-		Tool = new ClangTool(*cmpDB, cmpDB->getAllFiles());
+		files = cmpDB->getAllFiles();
 	}
+	if (options.shardCount > 1)
+		files = SelectShard(files, options.shardIndex, options.shardCount);
 
-
-	
 	clang::CompilerInstance comp;
 	comp.getPreprocessorOpts().addMacroDef("_W32BIT_");
 
 	initializeIgnored(ignoredFilePaths, ignoredNamespaces);
 
-	ClassDeclsCallback classCallback;
-	FeildDeclsCallback fieldCallback;
-	MethodDeclsCallback methodCallback;
-	MethodVarsCallback methodVarCallback;
-	MatchFinder Finder;
-	Finder.addMatcher(ClassDeclMatcher, &classCallback);
-	Finder.addMatcher(FieldDeclMatcher, &fieldCallback); 
-	Finder.addMatcher(MethodDeclMatcher, &methodCallback);
-	Finder.addMatcher(MethodVarMatcher, &methodVarCallback);
-	int result = Tool->run(newFrontendActionFactory(&Finder).get());
-
-	SetFiles(Tool, srcs, headers);
-	
-	delete Tool;
+	std::unique_ptr<MiningCache> cache;
+	if (options.cacheDir != "")
+		cache = std::make_unique<MiningCache>(options.cacheDir, std::vector<std::string>{ ignoredFilePaths, ignoredNamespaces }, GetCacheSettings(options));
+
+	unsigned jobs = options.jobs;
+	if (jobs == 0)
+		jobs = std::max(1u, std::thread::hardware_concurrency());
+	if (jobs > files.size())
+		jobs = std::max<unsigned>(1, files.size());
+
+	std::vector<std::string> visitedFiles;
+	int result;
+	if (jobs == 1 && !cache) {
+		result = RunTool(*cmpDB, files, options, structuresTable, visitedFiles);
+	}
+	else {
+		TUTimings timings;
+		if (options.timingsPath != "")
+			timings.Load(options.timingsPath);
+		result = RunWorkers(*cmpDB, files, jobs, options, cache.get(), timings, visitedFiles);
+		if (options.timingsPath != "" && !timings.Save(options.timingsPath))
+			std::cout << "Could not write the TU timings to " << options.timingsPath << "\n";
+	}
+
+	SetFiles(visitedFiles, srcs, headers);
 	return result;
 }
@@ -3,6 +3,7 @@
 #pragma warning(disable : 4146)
 
 #include <iostream>
+#include <unordered_set>
 #include "SymbolTable.h"
 #include "../Ignored/Ignored.h";
 #include "clang/Frontend/FrontendActions.h"
@@ -24,8 +25,158 @@ namespace dependenciesMining {
 	
 	// ----------------------------------------------------------------------------------
 
-	class ClassDeclsCallback : public MatchFinder::MatchCallback {
+	/*
+		Ignore verdicts (ignored["filePaths"]) of the files of a TU, by FileID: each file is classified once per TU.
+		The verdict of a file is the one of its name as presumed (#line) at its first lookup.
+	*/
+	class IgnoredFileIDs {
+		std::unordered_map<unsigned, bool> verdicts;
 	public:
+		bool IsIgnored(const PresumedLoc& loc);
+		void Clear() { verdicts.clear(); }
+	};
+
+	// Full name ("a::b::") and ignore verdict (ignored["namespaces"]) of a namespace
+	struct NamespaceInfo {
+		std::string name;
+		bool ignored = false;
+	};
+
+	/*
+		The enclosing namespaces of the records of a TU, by namespace (primary) DeclContext: 
+		each namespace is named and classified once per TU, from its parent.
+	*/
+	class NamespacesCache {
+		std::unordered_map<const DeclContext*, NamespaceInfo> namespaces;
+		const NamespaceInfo& Get(const DeclContext* context);
+	public:
+		const NamespaceInfo& Get(const RecordDecl* d);
+		void Clear() { namespaces.clear(); }
+	};
+
+	// Full name (GetFullStructureName / GetFullMethodName) and ID of a record or method
+	struct DeclName {
+		std::string name;
+		ID_T id = NO_ID;
+	};
+
+	/*
+		The names and IDs of the records and methods of a TU: each one is named (and its ID interned) once per TU.
+		Records by canonical Decl (all their redeclarations have the same name), methods by Decl 
+		(the argument list is spelled as in each declaration).
+		Clear (and the destructor) adds the hits and misses to the totals of GetNamingStats.
+	*/
+	class NamesCache {
+		std::unordered_map<const Decl*, DeclName> names;
+		size_t hits = 0;
+		size_t misses = 0;
+	public:
+		~NamesCache() { Clear(); }
+		const DeclName& Get(const RecordDecl* d);
+		const DeclName& Get(const CXXMethodDecl* d);
+		const DeclName& GetType(const QualType& type);		// of a structure type, or of the structure a pointer / reference type points to
+		void Clear();
+	};
+
+	struct NamingStats {
+		size_t hits = 0;
+		size_t misses = 0;
+	};
+
+	// NamesCache lookups of the TUs mined so far
+	NamingStats GetNamingStats();
+
+	// Caches of a TU, the Decls and FileIDs they refer to are valid until the end of the TU
+	struct TranslationUnitCaches {
+		IgnoredFileIDs ignoredFiles;
+		NamespacesCache namespaces;
+		NamesCache names;
+
+		void Clear() {
+			ignoredFiles.Clear();
+			namespaces.Clear();
+			names.Clear();
+		}
+	};
+
+	/*
+		The declarations already mined into a SymbolTable, by location (file, offset) and kind: the records, fields,
+		methods and variables of a header are mined by the first TU (of the table) that includes it, the next TUs skip them
+		(mining them again would not change the table, Install keeps the first symbol).
+		Only the decls that mine the same in every TU are registered, not:
+		implicit ones (declared on demand per TU), ones expanded from macros (they share the expansion location),
+		record declarations (mined as their definition when the TU has one) and anything within a template 
+		specialization (instantiations share the location of their template but differ per TU).
+		One registry per action factory, so per table: only a serial run without cache mines all its TUs into one table.
+		With jobs > 1 or a cache every TU has its own table (merged or stored on its own) and mines all the decls of its headers.
+	*/
+	class MinedDecls {
+		struct Key {
+			uint64_t device;
+			uint64_t file;
+			unsigned offset;
+			unsigned kind;
+			bool operator==(const Key& other) const { return device == other.device && file == other.file && offset == other.offset && kind == other.kind; }
+		};
+		struct KeyHash {
+			size_t operator()(const Key& key) const { return std::hash<uint64_t>()(key.file * 31 + key.device) ^ (((size_t)key.offset << 8) | key.kind); }
+		};
+		std::unordered_set<Key, KeyHash> mined;
+	public:
+		bool Insert(const Decl* d, const SourceManager& sm);				// false if d was mined already
+	};
+
+	// Identity, ignore status and namespace of a record, shared by its fields, methods and variables
+	struct RecordInfo {
+		ID_T id = NO_ID;							// set only if the namespace is not ignored
+		std::string nameSpace;
+		bool ignoredDecl = false;
+		bool ignoredNamespace = false;
+
+		RecordInfo() = default;
+		RecordInfo(const RecordDecl* d, TranslationUnitCaches& caches);
+	};
+
+	/*
+		Mining of the declarations, used by both mining engines (matcher callbacks and SinglePassMiner).
+		The base GetRecordInfo computes the record info on every call.
+	*/
+	class DeclMiner {
+	protected:
+		SymbolTable& table;
+		MinedDecls& mined;
+		SourceManager* sm;
+		TranslationUnitCaches& caches;
+		RecordInfo recordInfo;
+
+		void MineFundamentalField(const FieldDecl* d, const RecordInfo& parentInfo);
+	public:
+		DeclMiner(SymbolTable& table, MinedDecls& mined, SourceManager* sm, TranslationUnitCaches& caches) : table(table), mined(mined), sm(sm), caches(caches) {};
+		virtual ~DeclMiner() = default;
+		virtual const RecordInfo& GetRecordInfo(const RecordDecl* d);
+
+		void MineRecord(const CXXRecordDecl* d, StructureType structureType);
+		void MineField(const FieldDecl* d);
+		void MineMethod(const CXXMethodDecl* d);
+		void MineMethodVar(const VarDecl* d);
+	};
+
+	// ----------------------------------------------------------------------------------
+
+	// The SymbolTable a matcher callback fills (with its mined decls) and the caches of the current TU (shared by the callbacks)
+	class MiningCallback : public MatchFinder::MatchCallback {
+	protected:
+		SymbolTable& table;
+		MinedDecls& mined;
+		TranslationUnitCaches& caches;
+	public:
+		MiningCallback(SymbolTable& table, MinedDecls& mined, TranslationUnitCaches& caches) : table(table), mined(mined), caches(caches) {};
+		void onStartOfTranslationUnit() override { caches.Clear(); }
+	};
+
+	class ClassDeclsCallback : public MiningCallback {
+	public:
+		ClassDeclsCallback(SymbolTable& table, MinedDecls& mined, TranslationUnitCaches& caches) : MiningCallback(table, mined, caches) {};
 		virtual void run(const MatchFinder::MatchResult& result);
 		/*class FindFieldStmt : public RecursiveASTVisitor<FindFieldStmt> {
 		public:
@@ -33,43 +184,80 @@ namespace dependenciesMining {
 		};*/
 	};
 
-	class FeildDeclsCallback : public MatchFinder::MatchCallback {
-	private:
-		void installFundamentalField(const MatchFinder::MatchResult& result);
+	class FeildDeclsCallback : public MiningCallback {
 	public:
+		FeildDeclsCallback(SymbolTable& table, MinedDecls& mined, TranslationUnitCaches& caches) : MiningCallback(table, mined, caches) {};
 		virtual void run(const MatchFinder::MatchResult& result);
 	};
 
-	class MethodDeclsCallback : public MatchFinder::MatchCallback {
+	class MethodDeclsCallback : public MiningCallback {
 	public:
+		MethodDeclsCallback(SymbolTable& table, MinedDecls& mined, TranslationUnitCaches& caches) : MiningCallback(table, mined, caches) {};
 		virtual void run(const MatchFinder::MatchResult& result);
 
+		// State and metrics of a single method body traversal
+		struct TraversalContext {
+			Method* method = nullptr;
+			SourceManager* sm = nullptr;
+			SymbolTable* table = nullptr;
+			NamesCache* names = nullptr;
+			int literal_count = 0;
+			int statement_count = 0;
+			int loop_count = 0;
+			int branch_count = 0;
+			int scope_depth = -1;
+			int scope_max_depth = 0;
+
+			TraversalContext(Method* method, SourceManager* sm, SymbolTable* table, NamesCache* names) : method(method), sm(sm), table(table), names(names) {};
+		};
+
 		class FindMemberExprVisitor : public RecursiveASTVisitor<FindMemberExprVisitor> {
+			TraversalContext context;
 		public:
+			FindMemberExprVisitor(Method* method, SourceManager* sm, SymbolTable* table, NamesCache* names) : context(method, sm, table, names) {};
 			bool VisitMemberExpr(MemberExpr* expr);
 			bool TraverseStmt(Stmt* stmt);
+			const TraversalContext& GetContext() const;
 		};
-	private: 
-		friend FindMemberExprVisitor;
-		inline static Method* currentMethod = nullptr;
-		inline static SourceManager* sm = nullptr;
-		inline static int literal_count;
-		inline static int statement_count;
-		inline static int loop_count;
-		inline static int branch_count;
-		inline static int scope_depth;
-		inline static int scope_max_depth;
-	};
-
-	class MethodVarsCallback : public MatchFinder::MatchCallback {
+	};
+
+	class MethodVarsCallback : public MiningCallback {
 	public:
+		MethodVarsCallback(SymbolTable& table, MinedDecls& mined, TranslationUnitCaches& caches) : MiningCallback(table, mined, caches) {};
 		virtual void run(const MatchFinder::MatchResult& result);
 	};
 
 	// ----------------------------------------------------------------------------------
 
+	enum class MiningEngine {
+		Matchers,								// MatchFinder with the four matchers and their callbacks
+		SinglePass								// one RecursiveASTVisitor pass per TU (SinglePassMiner), EngineBenchmark only:
+												// not offered by main until it is shown to mine the ST of the matchers
+	};
+
+	enum class MiningDepth {
+		Full,									// structures, fields, methods with their arguments, definitions and bodies
+		Signatures,								// structures, fields and methods with their arguments: no function body is parsed
+		Structure								// structures and fields only (bases, friends, nesting, template args): no function body is parsed
+	};
+
+	struct MiningOptions {
+		unsigned jobs = 1;						// worker threads (0: one per hardware thread)
+		std::string cacheDir = "";				// incremental mining cache directory (no cache if empty)
+		MiningEngine engine = MiningEngine::Matchers;
+		bool skipIgnoredBodies = false;			// do not parse the function bodies of the ignored files, strip the code generation flags
+		MiningDepth depth = MiningDepth::Full;
+		std::string timingsPath = "";			// per TU mining durations of the previous runs, to dispatch the longest TUs first (none if empty)
+		unsigned shardIndex = 0;				// mine only the TUs of shard shardIndex (0 ... shardCount - 1)
+		unsigned shardCount = 1;
+	};
+
+	// Creates the FrontendActions that mine a TU into table (options: engine, skipIgnoredBodies and depth)
+	std::unique_ptr<FrontendActionFactory> NewMiningActionFactory(const MiningOptions& options, SymbolTable& table);
+
 	std::unique_ptr<CompilationDatabase> LoadCompilationDatabase(const char*);
 	void SetFiles(ClangTool* tool, std::vector<std::string>& srcs, std::vector<std::string>& headers);
-	int CreateClangTool(const char* cmpDBPath, std::vector<std::string>& srcs, std::vector<std::string>& headers, const char* ignoredFilePaths, const char* ignoredNamespaces);
+	void SetFiles(const std::vector<std::string>& paths, std::vector<std::string>& srcs, std::vector<std::string>& headers);
+	int CreateClangTool(const char* cmpDBPath, std::vector<std::string>& srcs, std::vector<std::string>& headers, const char* ignoredFilePaths, const char* ignoredNamespaces, const MiningOptions& options = MiningOptions());
 
 }
@@ -0,0 +1,56 @@
+#include "SinglePassMiner.h"
+#include "Utilities.h"
+#include "Tracing.h"
+
+using namespace dependenciesMining;
+
+// ----------------------------------------------------------------------------------------------
+
+// Computed once per record (per TU)
+const RecordInfo& SinglePassMiner::GetRecordInfo(const RecordDecl* d) {
+	auto it = records.find(d);
+	if (it == records.end())
+		it = records.emplace(d, RecordInfo(d, caches)).first;
+	return it->second;
+}
+
+bool SinglePassMiner::VisitCXXRecordDecl(CXXRecordDecl* d) {
+	tracing::Total total("SinglePassMiner::VisitCXXRecordDecl");
+	if (d->isClass())
+		MineRecord(d, StructureType::Class);
+	else if (d->isStruct())
+		MineRecord(d, StructureType::Struct);
+	return true;
+}
+
+bool SinglePassMiner::VisitFieldDecl(FieldDecl* d) {
+	tracing::Total total("SinglePassMiner::VisitFieldDecl");
+	MineField(d);
+	return true;
+}
+
+bool SinglePassMiner::VisitCXXMethodDecl(CXXMethodDecl* d) {
+	tracing::Total total("SinglePassMiner::VisitCXXMethodDecl");
+	if (depth != MiningDepth::Structure)
+		MineMethod(d);
+	return true;
+}
+
+bool SinglePassMiner::VisitVarDecl(VarDecl* d) {
+	tracing::Total total("SinglePassMiner::VisitVarDecl");
+	if (depth != MiningDepth::Structure)
+		MineMethodVar(d);
+	return true;
+}
+
+// ----------------------------------------------------------------------------------------------
+
+void SinglePassConsumer::HandleTranslationUnit(ASTContext& context) {
+	TranslationUnitCaches caches;
+	SinglePassMiner miner(table, mined, &context.getSourceManager(), caches, depth);
+	miner.TraverseDecl(context.getTranslationUnitDecl());
+}
+
+std::unique_ptr<ASTConsumer> SinglePassAction::CreateASTConsumer(CompilerInstance& compiler, StringRef file) {
+	return std::make_unique<SinglePassConsumer>(table, mined, depth);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "DependenciesMining.h"
+#include "clang/Frontend/FrontendAction.h"
+
+namespace dependenciesMining {
+
+	/*
+		Mines a whole TU in a single RecursiveASTVisitor pass, instead of one MatchFinder pass with four matchers.
+		The identity, ignore status and namespace of each record are computed once 
+		and reused by its fields, methods and variables.
+		Template instantiations and implicit code are visited, as the matchers match them. That it mines the same
+		declarations in the same order as the MatchFinder is not verified: EngineBenchmark compares the two STs.
+	*/
+	class SinglePassMiner : public RecursiveASTVisitor<SinglePassMiner>, public DeclMiner {
+		std::unordered_map<const RecordDecl*, RecordInfo> records;
+		MiningDepth depth;
+	public:
+		SinglePassMiner(SymbolTable& table, MinedDecls& mined, SourceManager* sm, TranslationUnitCaches& caches, MiningDepth depth) : DeclMiner(table, mined, sm, caches), depth(depth) {};
+		const RecordInfo& GetRecordInfo(const RecordDecl* d) override;
+
+		bool shouldVisitTemplateInstantiations() const { return true; }
+		bool shouldVisitImplicitCode() const { return true; }
+
+		bool VisitCXXRecordDecl(CXXRecordDecl* d);
+		bool VisitFieldDecl(FieldDecl* d);
+		bool VisitCXXMethodDecl(CXXMethodDecl* d);
+		bool VisitVarDecl(VarDecl* d);
+	};
+
+	class SinglePassConsumer : public ASTConsumer {
+		SymbolTable& table;
+		MinedDecls& mined;
+		MiningDepth depth;
+	public:
+		SinglePassConsumer(SymbolTable& table, MinedDecls& mined, MiningDepth depth) : table(table), mined(mined), depth(depth) {};
+		void HandleTranslationUnit(ASTContext& context) override;
+	};
+
+	class SinglePassAction : public ASTFrontendAction {
+		SymbolTable& table;
+		MinedDecls& mined;
+		MiningDepth depth;
+	public:
+		SinglePassAction(SymbolTable& table, MinedDecls& mined, MiningDepth depth) : table(table), mined(mined), depth(depth) {};
+		std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance& compiler, StringRef file) override;
+	};
+}
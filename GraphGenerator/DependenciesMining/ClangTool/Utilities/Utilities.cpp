@@ -154,31 +154,36 @@ std::string dependenciesMining::GetFullMethodName(const CXXMethodDecl* d) {
 	return name;
 }
 
+// Innermost namespace first, appended in reverse (no prepending)
 std::string dependenciesMining::GetFullNamespaceName(const RecordDecl* d) {
+	std::vector<const NamespaceDecl*> namespaces;
 	auto* enclosingNamespace = d->getEnclosingNamespaceContext();
-	std::string fullEnclosingNamespace = "";
 	while (enclosingNamespace->isNamespace()) {
-		auto enclosingNamespaceName = ((NamespaceDecl*)enclosingNamespace)->getNameAsString();
-		fullEnclosingNamespace = enclosingNamespaceName + "::" + fullEnclosingNamespace;
+		namespaces.push_back((const NamespaceDecl*)enclosingNamespace);
 		enclosingNamespace = enclosingNamespace->getParent()->getEnclosingNamespaceContext();
 	}
+	std::string fullEnclosingNamespace = "";
+	for (auto it = namespaces.rbegin(); it != namespaces.rend(); ++it) {
+		fullEnclosingNamespace += (*it)->getNameAsString();
+		fullEnclosingNamespace += "::";
+	}
 	return fullEnclosingNamespace;
 }
 
 ID_T dependenciesMining::GetIDfromDecl(const RecordDecl* d) {
-	return GetFullStructureName(d);
+	return InternID(GetFullStructureName(d));
 }
 
 ID_T dependenciesMining::GetIDfromDecl(const CXXMethodDecl* d) {
-	return GetFullMethodName(d);
+	return InternID(GetFullMethodName(d));
 }
 
 ID_T dependenciesMining::GetIDfromDecl(const FieldDecl* d) {
-	return d->getQualifiedNameAsString();
+	return InternID(d->getQualifiedNameAsString());
 }
 
 ID_T dependenciesMining::GetIDfromDecl(const VarDecl* d) {
-	return d->getQualifiedNameAsString();
+	return InternID(d->getQualifiedNameAsString());
 }
 
 // -------------------------------------------------------------------------
@@ -5,8 +5,7 @@
 #include "clang/ASTMatchers/ASTMatchers.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
 #include <iostream>
-
-#define ID_T std::string
+#include "SymbolID.h"
 
 using namespace clang;
 using namespace clang::ast_matchers;
@@ -1,5 +1,6 @@
 #include "Ignored.h"
 #include <assert.h>
+#include <algorithm>
 
 using namespace dependenciesMining;
 
@@ -18,23 +19,47 @@ void Ignored::Remove(const std::string& entity) {
 // --------------------------------------------------------------------
 
 IgnoredNamespaces::IgnoredNamespaces(const std::string& inputFile)  {
-	Insert("std");
-	if (inputFile == "")
-		return;
-	std::string line;
-	std::ifstream file(inputFile);
-	if (file.is_open()) {
-		while (std::getline(file, line)) {
-			Insert(line);
+	Ignored::Insert("std");
+	if (inputFile != "") {
+		std::string line;
+		std::ifstream file(inputFile);
+		if (file.is_open()) {
+			while (std::getline(file, line)) {
+				Ignored::Insert(line);
+			}
 		}
 	}
+	Compile();
 };
 
+void IgnoredNamespaces::Insert(const std::string& entity) {
+	Ignored::Insert(entity);
+	Compile();
+}
+
+void IgnoredNamespaces::Remove(const std::string& entity) {
+	Ignored::Remove(entity);
+	Compile();
+}
+
+// The views refer to the strings of entities (list nodes, not moved)
+void IgnoredNamespaces::Compile() {
+	prefixes.clear();
+	lengths.clear();
+	for (const auto& entity : entities) {
+		prefixes.insert(entity);
+		lengths.push_back(entity.length());
+	}
+	std::sort(lengths.begin(), lengths.end());
+	lengths.erase(std::unique(lengths.begin(), lengths.end()), lengths.end());
+}
+
 bool IgnoredNamespaces::isIgnored(const std::string& nameSpace) {
-	for (auto n : entities) {
-		if (nameSpace.find(n) == 0) {
+	for (auto length : lengths) {
+		if (length > nameSpace.length())
+			break;
+		if (prefixes.count(std::string_view(nameSpace.data(), length)))
 			return true;
-		}
 	}
 	return false;
 }
@@ -124,28 +149,87 @@ IgnoredFilePaths::IgnoredFilePaths(const std::string& inputFile) {
 	if (systemFile.is_open()) {
 		while (std::getline(systemFile, line)) {
 			line = PathFix(line);
-			Insert(line);
+			Ignored::Insert(line);
 		}
 	}
 
 	// user defined inputFile
-	if (inputFile == "")
-		return;
-	std::ifstream userFile(inputFile);
-	if (userFile.is_open()) {
-		while (std::getline(userFile, line)) {
-			line = PathFix(line);
-			Insert(line);
+	if (inputFile != "") {
+		std::ifstream userFile(inputFile);
+		if (userFile.is_open()) {
+			while (std::getline(userFile, line)) {
+				line = PathFix(line);
+				Ignored::Insert(line);
+			}
 		}
 	}
+	Compile();
 }
 
-bool IgnoredFilePaths::isIgnored(const std::string& file) {
-	std::string fileFixed = PathFix(file);
-	for (auto n : entities) {
-		if (fileFixed.find(n) <= fileFixed.length()) {
-			return true;
+void IgnoredFilePaths::Insert(const std::string& entity) {
+	Ignored::Insert(entity);
+	Compile();
+}
+
+void IgnoredFilePaths::Remove(const std::string& entity) {
+	Ignored::Remove(entity);
+	Compile();
+}
+
+// Trie of the entities, then the failure links (breadth first) turn it into a DFA
+void IgnoredFilePaths::Compile() {
+	constexpr unsigned None = 0;								// no trie edge (the start state is never a target)
+	transitions.assign(Alphabet, None);
+	accepting.assign(1, false);
+
+	for (const auto& entity : entities) {
+		unsigned state = 0;
+		for (unsigned char c : entity) {
+			unsigned& next = transitions[state * Alphabet + c];
+			if (next == None) {
+				next = (unsigned)accepting.size();
+				accepting.push_back(false);
+				transitions.resize(transitions.size() + Alphabet, None);
+			}
+			state = transitions[state * Alphabet + c];
+		}
+		accepting[state] = true;
+	}
+
+	std::vector<unsigned> failure(accepting.size(), 0);
+	std::vector<unsigned> queue;
+	for (unsigned c = 0; c < Alphabet; ++c) {
+		if (auto next = transitions[c])
+			queue.push_back(next);
+	}
+	for (size_t i = 0; i < queue.size(); ++i) {
+		unsigned state = queue[i];
+		accepting[state] = accepting[state] || accepting[failure[state]];
+		for (unsigned c = 0; c < Alphabet; ++c) {
+			unsigned& next = transitions[state * Alphabet + c];
+			if (next == None) {
+				next = transitions[failure[state] * Alphabet + c];
+			}
+			else {
+				failure[next] = transitions[failure[state] * Alphabet + c];
+				queue.push_back(next);
+			}
 		}
 	}
+}
+
+bool IgnoredFilePaths::Match(const std::string& path) const {
+	if (accepting[0])											// an empty entity
+		return true;
+	unsigned state = 0;
+	for (unsigned char c : path) {
+		state = transitions[state * Alphabet + c];
+		if (accepting[state])
+			return true;
+	}
 	return false;
 }
+
+bool IgnoredFilePaths::isIgnored(const std::string& file) {
+	return Match(PathFix(file));
+}
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <vector>
 #include <stack>
+#include <string_view>
+#include <unordered_set>
 
 namespace dependenciesMining {
 	
@@ -12,6 +14,7 @@ namespace dependenciesMining {
 	protected:
 		std::list<std::string> entities;
 	public:
+		virtual ~Ignored() = default;
 		virtual void Insert(const std::string& entity);
 		virtual void Remove(const std::string& entity);
 		virtual bool isIgnored(const std::string& entity) = 0;
@@ -19,16 +22,40 @@ namespace dependenciesMining {
 
 	// --------------------------------------------------------------------
 
+	/*
+		A namespace is ignored if it starts with any of the entities. The entities are kept in a hash set
+		(of views to them), a namespace is looked up by its prefixes of the entity lengths only.
+	*/
 	class IgnoredNamespaces : public Ignored {
+	private:
+		std::unordered_set<std::string_view> prefixes;
+		std::vector<size_t> lengths;							// the distinct entity lengths, ascending
+
+		void Compile();
 	public:
 		IgnoredNamespaces(const std::string& inputFile = ""); 
+		virtual void Insert(const std::string& entity);
+		virtual void Remove(const std::string& entity);
 		virtual bool isIgnored(const std::string& nameSpace);
 	};
 
 	// --------------------------------------------------------------------
 
+	/*
+		A file is ignored if its fixed path contains any of the entities. The entities are compiled into 
+		an Aho-Corasick automaton (a DFA over the path bytes), so that a path is matched against all of them 
+		in one pass. The automaton is rebuilt by Insert and Remove, isIgnored does not modify it 
+		(it is used by the mining workers concurrently).
+	*/
 	class IgnoredFilePaths : public Ignored {
 	private:
+		static constexpr unsigned Alphabet = 256;
+		std::vector<unsigned> transitions;						// transitions[state * Alphabet + byte], state 0: start
+		std::vector<bool> accepting;							// an entity ends at the state (or at one of its suffixes)
+
+		void Compile();
+		bool Match(const std::string& path) const;
+
 		void ReplaceSubStrings(std::string& str, const std::string& replaceThis, const std::string& replaceWith);
 		void SplitStrWithChar(std::vector<std::string>& splitStr, const std::string& str, const char c);
 		void ReverseStack(std::stack<std::string>& stack);
@@ -36,6 +63,8 @@ namespace dependenciesMining {
 		std::string PathFix(std::string filePath);
 	public:
 		IgnoredFilePaths(const std::string& inputFile = "");
+		virtual void Insert(const std::string& entity);
+		virtual void Remove(const std::string& entity);
 		virtual bool isIgnored(const std::string& file);
 	};
 
@@ -0,0 +1,171 @@
+#include "MiningCache.h"
+#include "STSerialization.h"
+#include <fstream>
+#include <sstream>
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace dependenciesMining;
+
+/*
+	Entry layout:
+		CSDC <version>
+		<key>
+		<number of files>
+		<content hash> <path>			// one line per file the TU opened (the TU included)
+		<serialized SymbolTable>
+*/
+
+// ----------------------------------------------------------------------------------------
+
+MiningCache::MiningCache(const std::string& dir, const std::vector<std::string>& configFiles, const std::string& settings) : dir(dir) {
+	std::string config = settings;
+	config.push_back('\0');
+	for (const auto& path : configFiles) {
+		config += path;
+		config.push_back('\0');
+		if (path == "")
+			continue;
+		if (auto buffer = llvm::MemoryBuffer::getFile(path))
+			config += (*buffer)->getBuffer().str();
+		config.push_back('\0');
+	}
+	configHash = llvm::xxHash64(config);
+}
+
+std::string MiningCache::GetAbsolutePath(const std::string& path, const std::string& directory) {
+	llvm::SmallString<256> absolute(path);
+	if (llvm::sys::path::is_relative(absolute)) {
+		absolute = directory;
+		llvm::sys::path::append(absolute, path);
+	}
+	llvm::sys::fs::make_absolute(absolute);
+	llvm::sys::path::remove_dots(absolute, true);
+	return absolute.str().str();
+}
+
+bool MiningCache::HashFile(const std::string& path, uint64_t& hash) {
+	{
+		std::lock_guard<std::mutex> lock(hashesMutex);
+		auto it = fileHashes.find(path);
+		if (it != fileHashes.end()) {
+			hash = it->second.second;
+			return it->second.first;
+		}
+	}
+	auto buffer = llvm::MemoryBuffer::getFile(path);
+	bool exists = (bool)buffer;
+	hash = exists ? llvm::xxHash64((*buffer)->getBuffer()) : 0;
+
+	std::lock_guard<std::mutex> lock(hashesMutex);
+	fileHashes[path] = { exists, hash };
+	return exists;
+}
+
+// Hash of the compile command(s) of a TU and the mining configuration
+uint64_t MiningCache::GetKey(const std::vector<clang::tooling::CompileCommand>& commands) const {
+	std::string key = llvm::utohexstr(configHash);
+	for (const auto& command : commands) {
+		key.push_back('\0');
+		key += command.Directory;
+		key.push_back('\0');
+		key += command.Filename;
+		for (const auto& arg : command.CommandLine) {
+			key.push_back('\0');
+			key += arg;
+		}
+	}
+	return llvm::xxHash64(key);
+}
+
+std::string MiningCache::GetEntryPath(const std::string& file) const {
+	llvm::SmallString<256> entryPath(dir);
+	llvm::sys::path::append(entryPath, llvm::utohexstr(llvm::xxHash64(file)) + ".tu");
+	return entryPath.str().str();
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool MiningCache::Load(const std::string& file, const std::vector<clang::tooling::CompileCommand>& commands, SymbolTable& table, std::vector<std::string>& visitedFiles) {
+	if (commands.empty())
+		return false;
+	const auto& directory = commands.front().Directory;
+	std::ifstream in(GetEntryPath(GetAbsolutePath(file, directory)), std::ios::binary);
+	if (!in.is_open())
+		return false;
+
+	std::string line;
+	if (!std::getline(in, line) || line != MINING_CACHE_MAGIC " " + std::to_string(MINING_CACHE_VERSION))
+		return false;
+	if (!std::getline(in, line) || line != llvm::utohexstr(GetKey(commands)))
+		return false;
+	if (!std::getline(in, line))
+		return false;
+
+	std::vector<std::string> files;
+	size_t count = std::strtoull(line.c_str(), nullptr, 10);
+	for (size_t i = 0; i < count; ++i) {
+		if (!std::getline(in, line))
+			return false;
+		auto space = line.find(' ');
+		if (space == std::string::npos)
+			return false;
+		std::string path = line.substr(space + 1);
+		uint64_t hash;
+		if (!HashFile(GetAbsolutePath(path, directory), hash) || llvm::utohexstr(hash) != line.substr(0, space))
+			return false;
+		files.push_back(path);
+	}
+
+	SymbolTable tuTable;
+	if (!ReadSymbolTable(in, tuTable))
+		return false;
+	table.Merge(tuTable);
+	visitedFiles.insert(visitedFiles.end(), files.begin(), files.end());
+	return true;
+}
+
+/*
+	Written to a temporary file and renamed, concurrent runs never see a partial entry.
+*/
+void MiningCache::Store(const std::string& file, const std::vector<clang::tooling::CompileCommand>& commands, const SymbolTable& table, const std::vector<std::string>& visitedFiles) {
+	if (commands.empty())
+		return;
+	const auto& directory = commands.front().Directory;
+
+	std::ostringstream entry;
+	entry << MINING_CACHE_MAGIC << " " << MINING_CACHE_VERSION << "\n";
+	entry << llvm::utohexstr(GetKey(commands)) << "\n";
+	entry << visitedFiles.size() << "\n";
+	for (const auto& path : visitedFiles) {
+		uint64_t hash;
+		if (!HashFile(GetAbsolutePath(path, directory), hash))
+			return;
+		entry << llvm::utohexstr(hash) << " " << path << "\n";
+	}
+	WriteSymbolTable(entry, table);
+
+	if (llvm::sys::fs::create_directories(dir))
+		return;
+	int fd;
+	llvm::SmallString<256> tmpPath;
+	if (llvm::sys::fs::createUniqueFile(dir + "/%%%%%%%%.tmp", fd, tmpPath))
+		return;
+	{
+		llvm::raw_fd_ostream out(fd, /*shouldClose=*/true);
+		out << entry.str();
+		out.close();
+		if (out.has_error()) {
+			out.clear_error();
+			llvm::sys::fs::remove(tmpPath);
+			return;
+		}
+	}
+	if (llvm::sys::fs::rename(tmpPath, GetEntryPath(GetAbsolutePath(file, directory))))
+		llvm::sys::fs::remove(tmpPath);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include "SymbolTable.h"
+#include "clang/Tooling/CompilationDatabase.h"
+
+/*
+	On disk cache of what each TU contributed to the SymbolTable.
+	One entry per TU (main file), valid while:
+		- the compile command(s) of the TU are the same
+		- the ignored file paths / namespaces and the mining settings are the same
+		- the contents of the TU and all the files it included are the same
+	A valid entry is loaded instead of running Clang over the TU.
+*/
+
+#define MINING_CACHE_MAGIC "CSDC"
+#define MINING_CACHE_VERSION 1
+
+namespace dependenciesMining {
+
+	class MiningCache {
+	private:
+		std::string dir;
+		uint64_t configHash = 0;
+		std::mutex hashesMutex;
+		std::unordered_map<std::string, std::pair<bool, uint64_t>> fileHashes;		// <absolute path, <exists, content hash>>, per run
+
+		bool HashFile(const std::string& path, uint64_t& hash);
+		uint64_t GetKey(const std::vector<clang::tooling::CompileCommand>& commands) const;
+		std::string GetEntryPath(const std::string& file) const;
+		static std::string GetAbsolutePath(const std::string& path, const std::string& directory);
+
+	public:
+		// configFiles: files that affect the mining output (ignored file paths / namespaces), settings: the mining options that do
+		MiningCache(const std::string& dir, const std::vector<std::string>& configFiles, const std::string& settings = "");
+
+		// Returns true on hit, table and visitedFiles are filled with the cached TU contribution
+		bool Load(const std::string& file, const std::vector<clang::tooling::CompileCommand>& commands, SymbolTable& table, std::vector<std::string>& visitedFiles);
+		void Store(const std::string& file, const std::vector<clang::tooling::CompileCommand>& commands, const SymbolTable& table, const std::vector<std::string>& visitedFiles);
+	};
+}
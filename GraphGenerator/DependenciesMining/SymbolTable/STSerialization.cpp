@@ -0,0 +1,484 @@
+#include "STSerialization.h"
+#include <cstring>
+#include <iterator>
+
+using namespace dependenciesMining;
+
+// ----------------------------------------------------------------------------------------
+
+class STWriter {
+	std::string body;
+	std::unordered_map<std::string, uint64_t> stringIndex;
+	std::vector<const std::string*> strings;
+	std::unordered_map<const Symbol*, uint64_t> structureIndex;
+
+	void WriteUInt(uint64_t value);
+	void WriteInt(int64_t value);
+	void WriteString(const std::string& str);
+	void WriteID(ID_T id);
+	void WriteStructureRef(const Symbol* structure);
+	void WriteSourceInfo(const SourceInfo& info);
+	void WriteSymbol(const Symbol* symbol);
+	void WriteStructureTable(const SymbolTable& table);
+	void WriteDefinition(ID_T key, const Definition* definition);
+	void WriteMethod(ID_T key, const Method* method);
+	void WriteStructure(const Structure* structure);
+public:
+	void Write(std::ostream& out, const SymbolTable& st);
+};
+
+// LEB128
+void STWriter::WriteUInt(uint64_t value) {
+	while (value >= 0x80) {
+		body.push_back((char)(value | 0x80));
+		value >>= 7;
+	}
+	body.push_back((char)value);
+}
+
+// zigzag, keeps -1 (Undefined, unknown) in one byte
+void STWriter::WriteInt(int64_t value) {
+	WriteUInt(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+void STWriter::WriteString(const std::string& str) {
+	auto it = stringIndex.find(str);
+	if (it == stringIndex.end()) {
+		it = stringIndex.insert({ str, strings.size() }).first;
+		strings.push_back(&it->first);
+	}
+	WriteUInt(it->second);
+}
+
+// IDs are only valid during a run, their strings are written
+void STWriter::WriteID(ID_T id) {
+	WriteString(GetIDString(id));
+}
+
+// 0 for nullptr, (structure index + 1) otherwise
+void STWriter::WriteStructureRef(const Symbol* structure) {
+	if (!structure) {
+		WriteUInt(0);
+		return;
+	}
+	auto it = structureIndex.find(structure);
+	assert(it != structureIndex.end());			// every referenced structure is installed in the table
+	WriteUInt(it != structureIndex.end() ? it->second + 1 : 0);
+}
+
+void STWriter::WriteSourceInfo(const SourceInfo& info) {
+	WriteString(info.GetFileName());
+	WriteInt(info.GetLine());
+	WriteInt(info.GetColumn());
+}
+
+void STWriter::WriteSymbol(const Symbol* symbol) {
+	WriteID(symbol->GetID());
+	WriteString(symbol->GetName());
+	WriteString(symbol->GetNamespace());
+	WriteSourceInfo(symbol->GetSourceInfo());
+	WriteInt((int)symbol->GetAccessType());
+}
+
+// bases, contains, friends, template arguments: <key, Structure*>
+void STWriter::WriteStructureTable(const SymbolTable& table) {
+	WriteUInt(std::distance(table.begin(), table.end()));
+	for (const auto& it : table) {
+		WriteID(it.first);
+		WriteStructureRef(it.second);
+	}
+}
+
+void STWriter::WriteDefinition(ID_T key, const Definition* definition) {
+	WriteID(key);
+	WriteSymbol(definition);
+	WriteStructureRef(definition->GetType());
+	WriteString(definition->GetFullType());
+}
+
+void STWriter::WriteMethod(ID_T key, const Method* method) {
+	WriteID(key);
+	WriteSymbol(method);
+	WriteInt((int)method->GetMethodType());
+	WriteStructureRef(method->GetReturnType());
+	WriteStructureTable(method->GetTemplateArguments());
+
+	const auto& args = method->GetArguments();
+	WriteUInt(std::distance(args.begin(), args.end()));
+	for (const auto& it : args) {
+		WriteDefinition(it.first, (Definition*)it.second);
+	}
+	const auto& defs = method->GetDefinitions();
+	WriteUInt(std::distance(defs.begin(), defs.end()));
+	for (const auto& it : defs) {
+		WriteDefinition(it.first, (Definition*)it.second);
+	}
+
+	const auto& memberExprs = method->GetMemberExpr();
+	WriteUInt(memberExprs.size());
+	for (const auto& it : memberExprs) {
+		const auto& expr = it.second;
+		WriteString(it.first);
+		WriteString(expr.GetExpr());
+		WriteSourceInfo(expr.GetSourceInfo());
+		WriteSourceInfo(expr.GetLocEnd());
+		const auto& members = expr.GetMembers();
+		WriteUInt(members.size());
+		for (const auto& member : members) {
+			WriteString(member.GetName());
+			WriteStructureRef(member.GetType());
+			WriteSourceInfo(member.GetLocEnd());
+			WriteString(member.GetMemberType());
+		}
+	}
+
+	WriteInt(method->GetLiterals());
+	WriteInt(method->GetStatements());
+	WriteInt(method->GetBranches());
+	WriteInt(method->GetLoops());
+	WriteInt(method->GetMaxScopeDepth());
+	WriteInt(method->GetLineCount());
+	WriteUInt(method->IsVirtual());
+	WriteUInt(method->IsBodyMined());
+}
+
+void STWriter::WriteStructure(const Structure* structure) {
+	WriteStructureRef(structure->GetTemplateParent());
+	WriteStructureRef(structure->GetNestedParent());
+	WriteStructureTable(structure->GetTemplateArguments());
+	WriteStructureTable(structure->GetBases());
+	WriteStructureTable(structure->GetContains());
+	WriteStructureTable(structure->GetFriends());
+
+	const auto& fields = structure->GetFields();
+	WriteUInt(std::distance(fields.begin(), fields.end()));
+	for (const auto& it : fields) {
+		WriteDefinition(it.first, (Definition*)it.second);
+	}
+	const auto& methods = structure->GetMethods();
+	WriteUInt(std::distance(methods.begin(), methods.end()));
+	for (const auto& it : methods) {
+		WriteMethod(it.first, (Method*)it.second);
+	}
+}
+
+/*
+	Layout: magic, version, string table, structure headers (so every structure index is known
+	before it is referenced), structure contents in the same order.
+*/
+void STWriter::Write(std::ostream& out, const SymbolTable& st) {
+	std::vector<const Structure*> structures;
+	for (const auto& it : st) {
+		assert(it.second->GetClassType() == ClassType::Structure);
+		structureIndex[it.second] = structures.size();
+		structures.push_back((Structure*)it.second);
+	}
+
+	WriteUInt(structures.size());
+	for (auto* structure : structures) {
+		WriteSymbol(structure);
+		WriteInt((int)structure->GetStructureType());
+	}
+	for (auto* structure : structures) {
+		WriteStructure(structure);
+	}
+
+	std::string body;
+	body.swap(this->body);
+	WriteUInt(ST_SERIALIZATION_VERSION);
+	WriteUInt(strings.size());
+	for (auto* str : strings) {
+		WriteUInt(str->size());
+		this->body += *str;
+	}
+
+	out.write(ST_SERIALIZATION_MAGIC, 4);
+	out.write(this->body.data(), this->body.size());
+	out.write(body.data(), body.size());
+}
+
+// ----------------------------------------------------------------------------------------
+
+class STReader {
+	std::string data;
+	size_t pos = 0;
+	bool failed = false;
+	std::vector<std::string> strings;
+	std::vector<Structure*> structures;
+
+	uint64_t ReadUInt();
+	int64_t ReadInt();
+	const std::string& ReadString();
+	ID_T ReadID();
+	Structure* ReadStructureRef();
+	SourceInfo ReadSourceInfo();
+	void ReadSymbol(Symbol& symbol);
+	template<typename Install_T> void ReadStructureTable(const Install_T& install);
+	ID_T ReadDefinition(Definition& definition);
+	void ReadMethod(Structure* structure);
+	void ReadStructure(Structure* structure);
+public:
+	bool Read(std::istream& in, SymbolTable& st);
+};
+
+uint64_t STReader::ReadUInt() {
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (pos >= data.size()) {
+			failed = true;
+			return 0;
+		}
+		unsigned char byte = data[pos++];
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+	failed = true;
+	return 0;
+}
+
+int64_t STReader::ReadInt() {
+	uint64_t value = ReadUInt();
+	return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+const std::string& STReader::ReadString() {
+	static const std::string empty;
+	uint64_t index = ReadUInt();
+	if (index >= strings.size()) {
+		failed = true;
+		return empty;
+	}
+	return strings[index];
+}
+
+ID_T STReader::ReadID() {
+	return InternID(ReadString());
+}
+
+Structure* STReader::ReadStructureRef() {
+	uint64_t ref = ReadUInt();
+	if (ref == 0)
+		return nullptr;
+	if (ref > structures.size()) {
+		failed = true;
+		return nullptr;
+	}
+	return structures[ref - 1];
+}
+
+SourceInfo STReader::ReadSourceInfo() {
+	std::string fileName = ReadString();
+	int line = (int)ReadInt();
+	int column = (int)ReadInt();
+	return SourceInfo(fileName, line, column);
+}
+
+void STReader::ReadSymbol(Symbol& symbol) {
+	symbol.SetID(ReadID());
+	symbol.SetName(ReadString());
+	symbol.SetNamespace(ReadString());
+	symbol.SetSourceInfo(ReadSourceInfo());
+	symbol.SetAccessType((AccessType)ReadInt());
+}
+
+template<typename Install_T> void STReader::ReadStructureTable(const Install_T& install) {
+	uint64_t count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		ID_T key = ReadID();
+		Structure* structure = ReadStructureRef();
+		if (structure)
+			install(key, structure);
+	}
+}
+
+ID_T STReader::ReadDefinition(Definition& definition) {
+	ID_T key = ReadID();
+	ReadSymbol(definition);
+	definition.SetType(ReadStructureRef());
+	definition.SetFullType(ReadString());
+	return key;
+}
+
+void STReader::ReadMethod(Structure* structure) {
+	Method method;
+	ID_T key = ReadID();
+	ReadSymbol(method);
+	method.SetMethodType((MethodType)ReadInt());
+	method.SetReturnType(ReadStructureRef());
+	ReadStructureTable([&method](ID_T key, Structure* arg) { method.InstallTemplateSpecializationArguments(key, arg); });
+
+	uint64_t count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		Definition arg;
+		auto argKey = ReadDefinition(arg);
+		method.InstallArg(argKey, arg);
+	}
+	count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		Definition def;
+		auto defKey = ReadDefinition(def);
+		method.InstallDefinition(defKey, def);
+	}
+
+	count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		std::string locBegin = ReadString();
+		std::string exprStr = ReadString();
+		SourceInfo srcInfo = ReadSourceInfo();
+		SourceInfo locEnd = ReadSourceInfo();
+		Method::MemberExpr expr(exprStr, locEnd, srcInfo.GetFileName(), srcInfo.GetLine(), srcInfo.GetColumn());
+		uint64_t membersCount = ReadUInt();
+		for (uint64_t j = 0; j < membersCount && !failed; ++j) {
+			std::string name = ReadString();
+			Structure* type = ReadStructureRef();
+			SourceInfo memberLocEnd = ReadSourceInfo();
+			std::string memType = ReadString();
+			expr.InsertMember(Method::Member(name, type, memberLocEnd, memType));
+		}
+		method.UpdateMemberExpr(expr, locBegin);
+	}
+
+	method.SetLiterals((int)ReadInt());
+	method.SetStatements((int)ReadInt());
+	method.SetBranches((int)ReadInt());
+	method.SetLoops((int)ReadInt());
+	method.SetMaxScopeDepth((int)ReadInt());
+	method.SetLineCount((int)ReadInt());
+	method.SetVirtual(ReadUInt() != 0);
+	method.SetBodyMined(ReadUInt() != 0);
+	if (!failed)
+		structure->InstallMethod(key, method);
+}
+
+void STReader::ReadStructure(Structure* structure) {
+	if (auto* templateParent = ReadStructureRef())
+		structure->SetTemplateParent(templateParent);
+	if (auto* nestedParent = ReadStructureRef())
+		structure->SetNestedParent(nestedParent);
+	ReadStructureTable([structure](ID_T key, Structure* arg) { structure->InstallTemplateSpecializationArguments(key, arg); });
+	ReadStructureTable([structure](ID_T key, Structure* base) { structure->InstallBase(key, base); });
+	ReadStructureTable([structure](ID_T key, Structure* nested) { structure->InstallNestedClass(key, nested); });
+	ReadStructureTable([structure](ID_T key, Structure* friend_) { structure->InstallFriend(key, friend_); });
+
+	uint64_t count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		Definition field;
+		auto key = ReadDefinition(field);
+		structure->InstallField(key, field);
+	}
+	count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		ReadMethod(structure);
+	}
+}
+
+bool STReader::Read(std::istream& in, SymbolTable& st) {
+	data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	if (data.size() < 4 || data.compare(0, 4, ST_SERIALIZATION_MAGIC) != 0)
+		return false;
+	pos = 4;
+	if (ReadUInt() != ST_SERIALIZATION_VERSION)
+		return false;
+
+	uint64_t count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		uint64_t size = ReadUInt();
+		if (pos + size > data.size()) {
+			failed = true;
+			break;
+		}
+		strings.emplace_back(data, pos, size);
+		pos += size;
+	}
+
+	count = ReadUInt();
+	for (uint64_t i = 0; i < count && !failed; ++i) {
+		Structure structure;
+		ReadSymbol(structure);
+		structure.SetStructureType((StructureType)ReadInt());
+		structures.push_back((Structure*)st.Install(structure.GetID(), structure));
+	}
+	for (auto* structure : structures) {
+		if (failed)
+			break;
+		ReadStructure(structure);
+	}
+	return !failed;
+}
+
+// ----------------------------------------------------------------------------------------
+
+void dependenciesMining::WriteSymbolTable(std::ostream& out, const SymbolTable& st) {
+	STWriter writer;
+	writer.Write(out, st);
+}
+
+bool dependenciesMining::ReadSymbolTable(std::istream& in, SymbolTable& st) {
+	STReader reader;
+	return reader.Read(in, st);
+}
+
+// ----------------------------------------------------------------------------------------
+
+/*
+	Layout: magic, number of srcs, srcs, number of headers, headers (numbers and string sizes LEB128),
+	the serialized SymbolTable.
+*/
+
+static void WriteFileList(std::ostream& out, const std::vector<std::string>& files) {
+	auto writeUInt = [&out](uint64_t value) {
+		while (value >= 0x80) {
+			out.put((char)(value | 0x80));
+			value >>= 7;
+		}
+		out.put((char)value);
+	};
+	writeUInt(files.size());
+	for (const auto& file : files) {
+		writeUInt(file.size());
+		out.write(file.data(), file.size());
+	}
+}
+
+static bool ReadFileList(std::istream& in, std::vector<std::string>& files) {
+	auto readUInt = [&in](uint64_t& value) {
+		value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			int byte = in.get();
+			if (byte == EOF)
+				return false;
+			value |= (uint64_t)(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	};
+	uint64_t count;
+	if (!readUInt(count))
+		return false;
+	for (uint64_t i = 0; i < count; ++i) {
+		uint64_t size;
+		if (!readUInt(size))
+			return false;
+		std::string file(size, '\0');
+		if (!in.read(&file[0], size))
+			return false;
+		files.push_back(std::move(file));
+	}
+	return true;
+}
+
+void dependenciesMining::WritePartialST(std::ostream& out, const SymbolTable& st, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	out.write(PARTIAL_ST_MAGIC, 4);
+	WriteFileList(out, srcs);
+	WriteFileList(out, headers);
+	WriteSymbolTable(out, st);
+}
+
+bool dependenciesMining::ReadPartialST(std::istream& in, SymbolTable& st, std::vector<std::string>& srcs, std::vector<std::string>& headers) {
+	char magic[4];
+	if (!in.read(magic, 4) || std::memcmp(magic, PARTIAL_ST_MAGIC, 4) != 0)
+		return false;
+	return ReadFileList(in, srcs) && ReadFileList(in, headers) && ReadSymbolTable(in, st);
+}
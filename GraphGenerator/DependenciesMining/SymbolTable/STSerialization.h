@@ -0,0 +1,28 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+
+/*
+	Compact binary form of a SymbolTable: a header, a string table (every name, id and
+	file path is stored once) and the structure records with their methods and fields.
+	Structure pointers are stored as indices to the structure records.
+	Used to store what a TU contributed to the SymbolTable and to load it back
+	without running Clang.
+*/
+
+#define ST_SERIALIZATION_MAGIC "CSDT"
+#define ST_SERIALIZATION_VERSION 2
+#define PARTIAL_ST_MAGIC "CSPT"
+
+namespace dependenciesMining {
+
+	void WriteSymbolTable(std::ostream& out, const SymbolTable& st);
+	// Fills st with the structures read; returns false if the stream is not a (compatible) serialized SymbolTable
+	bool ReadSymbolTable(std::istream& in, SymbolTable& st);
+
+	// The output of a shard (--shard i/N): its sources and headers, then its serialized SymbolTable (merged by st-merge)
+	void WritePartialST(std::ostream& out, const SymbolTable& st, const std::vector<std::string>& srcs, const std::vector<std::string>& headers);
+	bool ReadPartialST(std::istream& in, SymbolTable& st, std::vector<std::string>& srcs, std::vector<std::string>& headers);
+}
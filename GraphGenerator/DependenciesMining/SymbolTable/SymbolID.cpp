@@ -0,0 +1,47 @@
+#include "SymbolID.h"
+#include <cassert>
+
+using namespace dependenciesMining;
+
+IDInterner::IDInterner() {
+	shards[0].strings.push_back("");								// NO_ID
+}
+
+ID_T IDInterner::Intern(const std::string& str) {
+	if (str.empty())
+		return NO_ID;
+	size_t hash = std::hash<std::string_view>()(str);
+	unsigned shardIndex = hash & ((1 << shardBits) - 1);
+	auto& shard = shards[shardIndex];
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	auto it = shard.ids.find(str);
+	if (it != shard.ids.end())
+		return it->second;
+	ID_T id = ((ID_T)shard.strings.size() << shardBits) | shardIndex;
+	shard.strings.push_back(str);								// deque: the views stay valid
+	shard.ids.emplace(shard.strings.back(), id);
+	return id;
+}
+
+const std::string& IDInterner::GetString(ID_T id) {
+	auto& shard = shards[id & ((1 << shardBits) - 1)];
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	assert((size_t)(id >> shardBits) < shard.strings.size());
+	return shard.strings[id >> shardBits];
+}
+
+// ----------------------------------------------------------------------------------------
+
+static IDInterner& GetInterner() {
+	static IDInterner interner;
+	return interner;
+}
+
+ID_T dependenciesMining::InternID(const std::string& str) {
+	return GetInterner().Intern(str);
+}
+
+const std::string& dependenciesMining::GetIDString(ID_T id) {
+	return GetInterner().GetString(id);
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#define ID_T int64_t 
+
+namespace dependenciesMining {
+
+	/*
+		Symbol IDs (fully qualified names) are interned to integers while mining: every string is stored once
+		and hashing / comparing / copying an ID_T is cheap. The strings are only needed for the output.
+		Thread safe (the mining workers intern concurrently). IDs are stable during a run, not across runs:
+		anything written to disk must store the strings.
+	*/
+	class IDInterner {
+	private:
+		static constexpr unsigned shardBits = 4;					// ID = (index in shard << shardBits) | shard
+		struct Shard {
+			std::mutex mutex;
+			std::unordered_map<std::string_view, ID_T> ids;		// views to strings
+			std::deque<std::string> strings;
+		};
+		Shard shards[1 << shardBits];
+	public:
+		IDInterner();
+		ID_T Intern(const std::string& str);
+		const std::string& GetString(ID_T id);
+	};
+
+	#define NO_ID 0													// the ID of ""
+
+	ID_T InternID(const std::string& str);
+	const std::string& GetIDString(ID_T id);
+}
@@ -1,8 +1,17 @@
 #include "SymbolTable.h"
 #include "STVisitor.h"
+#include "Arena.h"
 
 using namespace dependenciesMining;
 
+// the symbol that replaces structure after a merge (or structure itself)
+static Structure* Relinked(const SymbolMap& symbols, Structure* structure) {
+	auto it = symbols.find(structure);
+	if (it != symbols.end())
+		return (Structure*)it->second;
+	return structure;
+}
+
 // SourceInfo 
 std::string SourceInfo::GetFileName() const {
 	return fileName;
@@ -170,7 +179,7 @@ template<typename Parent_T> Parent_T* Template<Parent_T>::GetParent() const {
 	return parent;
 }
 
-template<typename Parent_T> SymbolTable Template<Parent_T>::GetArguments() const {
+template<typename Parent_T> const SymbolTable& Template<Parent_T>::GetArguments() const {
 	return arguments;
 }
 
@@ -182,6 +191,13 @@ template<typename Parent_T> Symbol* Template<Parent_T>::InstallArguments(const I
 	return arguments.Install(id, structure);
 }
 
+template<typename Parent_T> void Template<Parent_T>::Relink(const SymbolMap& symbols) {
+	auto it = symbols.find(parent);
+	if (it != symbols.end())
+		parent = (Parent_T*)it->second;
+	arguments.Relink(symbols);
+}
+
 
 //Definition
 bool Definition::isStructure() const {
@@ -205,6 +221,11 @@ void Definition::SetFullType(const std::string& type) {
 	full_type = type;
 }
 
+void Definition::Relink(const SymbolMap& symbols) {
+	if (type)
+		type = Relinked(symbols, type);
+}
+
 // Method
 MethodType Method::GetMethodType() const {
 	return methodType;
@@ -252,19 +273,19 @@ Structure* Method::GetReturnType() const {
 	return returnType;
 }
 
-SymbolTable Method::GetArguments() const {
+const SymbolTable& Method::GetArguments() const {
 	return arguments;
 }
 
-SymbolTable Method::GetDefinitions() const {
+const SymbolTable& Method::GetDefinitions() const {
 	return definitions;
 }
 
-SymbolTable Method::GetTemplateArguments() const {
+const SymbolTable& Method::GetTemplateArguments() const {
 	return templateInfo.GetArguments();
 }
 
-std::map<std::string, Method::MemberExpr>  Method::GetMemberExpr() const {
+const std::map<std::string, Method::MemberExpr>& Method::GetMemberExpr() const {
 	return memberExprs;
 }
 
@@ -332,6 +353,10 @@ void Method::SetVirtual(bool is_virtual) {
 	this->is_virtual = is_virtual;
 }
 
+void Method::SetBodyMined(bool bodyMined) {
+	this->bodyMined = bodyMined;
+}
+
 void Method::InstallArg(const ID_T& id, const Definition& definition) {
 	arguments.Install(id, definition);
 }
@@ -371,6 +396,52 @@ void Method::UpdateMemberExpr(MemberExpr const& memberExpr, const std::string& l
 	}
 }
 
+/*
+	First wins, as MineMethod mines a body once per table: arguments and definitions are kept, and so is
+	a mined body (metrics and MemberExprs), the body of other is ignored. A method mined without its body
+	(declared only) takes the body of other, as a serial run mines it into the method when the TU with the definition comes.
+	The access and virtual of a declaration only (unknown) are taken from other too.
+*/
+void Method::Merge(Method& other) {
+	if (access_type == AccessType::unknown && other.access_type != AccessType::unknown) {
+		access_type = other.access_type;
+		is_virtual = other.is_virtual;
+	}
+	if (!bodyMined && other.bodyMined) {
+		access_type = other.access_type;
+		is_virtual = other.is_virtual;
+		literals = other.literals;
+		statements = other.statements;
+		branches = other.branches;
+		loops = other.loops;
+		max_scope_depth = other.max_scope_depth;
+		line_count = other.line_count;
+		memberExprs = other.memberExprs;
+		bodyMined = true;
+	}
+	for (auto& it : other.arguments) {
+		arguments.Install(it.first, it.second);
+	}
+	for (auto& it : other.definitions) {
+		definitions.Install(it.first, it.second);
+	}
+}
+
+void Method::Relink(const SymbolMap& symbols) {
+	if (returnType)
+		returnType = Relinked(symbols, returnType);
+	templateInfo.Relink(symbols);
+	for (auto& it : arguments) {
+		((Definition*)it.second)->Relink(symbols);
+	}
+	for (auto& it : definitions) {
+		((Definition*)it.second)->Relink(symbols);
+	}
+	for (auto& it : memberExprs) {
+		it.second.Relink(symbols);
+	}
+}
+
 bool Method::IsConstructor() const {
 	if (methodType == MethodType::Constructor_UserDefined || methodType == MethodType::Constructor_Trivial)
 		return true; 
@@ -426,6 +497,10 @@ bool Method::IsVirtual() const {
 	return is_virtual;
 }
 
+bool Method::IsBodyMined() const {
+	return bodyMined;
+}
+
 // Member
 std::string Method::Member::GetName() const {
 	return name;
@@ -455,12 +530,17 @@ void Method::Member::SetType(Structure* type) {
 	this->type = type;
 }
 
+void Method::Member::Relink(const SymbolMap& symbols) {
+	if (type)
+		type = Relinked(symbols, type);
+}
+
 
 // MemberExpr 
 std::string Method::MemberExpr::GetExpr() const {
 	return expr;
 }
-std::vector<Method::Member> Method::MemberExpr::GetMembers() const {
+const std::vector<Method::Member>& Method::MemberExpr::GetMembers() const {
 	return members;
 }
 
@@ -484,6 +564,12 @@ void Method::MemberExpr::InsertMember(Member member) {
 	members.push_back(member);
 }
 
+void Method::MemberExpr::Relink(const SymbolMap& symbols) {
+	for (auto& member : members) {
+		member.Relink(symbols);
+	}
+}
+
 
 // Structure
 Structure::Structure(const Structure& s) {
@@ -539,27 +625,27 @@ Structure* Structure::GetNestedParent() const {
 	return nestedParent;
 }
 
-SymbolTable Structure::GetMethods() const {
+const SymbolTable& Structure::GetMethods() const {
 	return methods;
 }
 
-SymbolTable Structure::GetFields() const {
+const SymbolTable& Structure::GetFields() const {
 	return fields;
 }
 
-SymbolTable Structure::GetBases() const {
+const SymbolTable& Structure::GetBases() const {
 	return bases;
 }
 
-SymbolTable Structure::GetContains() const {
+const SymbolTable& Structure::GetContains() const {
 	return contains;
 }
 
-SymbolTable Structure::GetFriends() const {
+const SymbolTable& Structure::GetFriends() const {
 	return friends;
 }
 
-SymbolTable Structure::GetTemplateArguments() const {
+const SymbolTable& Structure::GetTemplateArguments() const {
 	return templateInfo.GetArguments(); 
 }
 
@@ -604,6 +690,48 @@ Symbol* Structure::InstallTemplateSpecializationArguments(const ID_T& id, Struct
 	return templateInfo.InstallArguments(id, structure);
 }
 
+/*
+	Mirrors Install(id, Structure): an Undefined placeholder is replaced by the definition (its members are dropped,
+	whichever of the two comes first), otherwise the first definition wins and only its member tables are completed.
+*/
+void Structure::Merge(Structure& other) {
+	if (IsUndefined() && !other.IsUndefined())
+		*this = other;
+	else if (IsUndefined() || !other.IsUndefined())
+		MergeMembers(other);
+}
+
+void Structure::MergeMembers(Structure& other) {
+	for (auto& it : other.methods) {
+		auto* method = (Method*)methods.Lookup(it.first);
+		if (method && method != it.second)
+			method->Merge(*(Method*)it.second);
+		else
+			methods.Install(it.first, it.second);
+	}
+	for (auto& it : other.fields) {
+		fields.Install(it.first, it.second);
+	}
+	for (auto& it : other.contains) {
+		contains.Install(it.first, it.second);
+	}
+}
+
+void Structure::Relink(const SymbolMap& symbols) {
+	templateInfo.Relink(symbols);
+	if (nestedParent)
+		nestedParent = Relinked(symbols, nestedParent);
+	for (auto& it : methods) {
+		((Method*)it.second)->Relink(symbols);
+	}
+	for (auto& it : fields) {
+		((Definition*)it.second)->Relink(symbols);
+	}
+	bases.Relink(symbols);
+	contains.Relink(symbols);
+	friends.Relink(symbols);
+}
+
 bool Structure::IsTemplateDefinition() const {
 	if (structureType == StructureType::TemplateDefinition)
 		return true;
@@ -655,13 +783,13 @@ Symbol* SymbolTable::Install(const ID_T& id, const std::string& name, const Clas
 
 	Symbol* dummy = nullptr;
 	if (type == ClassType::Structure) {
-		dummy = new Structure(id, name);
+		dummy = arena::New<Structure>(arena::Kind::Structure, id, name);
 	}
 	else if (type == ClassType::Method) {
-		dummy = new Method(id, name);
+		dummy = arena::New<Method>(arena::Kind::Method, id, name);
 	}
 	else if (type == ClassType::Definition) {
-		dummy = new Definition(id, name);
+		dummy = arena::New<Definition>(arena::Kind::Definition, id, name);
 	}
 	else {
 		assert(0);
@@ -683,7 +811,7 @@ Symbol* SymbolTable::Install(const ID_T& id, const Symbol& symbol) {
 		return it->second;
 	}
 
-	Symbol* newSymbol = new Symbol(symbol);
+	Symbol* newSymbol = arena::New<Symbol>(arena::Kind::Symbol, symbol);
 	byID[id] = newSymbol;
 
 	auto& nameList = byName[symbol.GetName()];
@@ -706,7 +834,7 @@ Symbol* SymbolTable::Install(const ID_T& id, const Structure& symbol) {
 		return it->second;		
 	}
 
-	Symbol* newSymbol = new Structure(symbol);
+	Symbol* newSymbol = arena::New<Structure>(arena::Kind::Structure, symbol);
 	byID[id] = newSymbol;
 	auto& nameList = byName[symbol.GetName()];
 	nameList.push_back(newSymbol);
@@ -720,7 +848,7 @@ Symbol* SymbolTable::Install(const ID_T& id, const Method& symbol) {
 			return it->second;
 	}
 
-	Symbol* newSymbol = new Method(symbol);
+	Symbol* newSymbol = arena::New<Method>(arena::Kind::Method, symbol);
 	byID[id] = newSymbol;
 	auto& nameList = byName[symbol.GetName()];
 	nameList.push_back(newSymbol);
@@ -732,7 +860,7 @@ Symbol* SymbolTable::Install(const ID_T& id, const Definition& symbol) {
 	if (it != byID.end()) 
 		return it->second;
 
-	Symbol* newSymbol = new Definition(symbol);
+	Symbol* newSymbol = arena::New<Definition>(arena::Kind::Definition, symbol);
 	byID[id] = newSymbol;
 
 	auto& nameList = byName[symbol.GetName()];
@@ -784,6 +912,49 @@ const Symbol* SymbolTable::Lookup(const ID_T& id) const {
 		return nullptr;
 }
 
+/*
+	Moves the structures of other (e.g. the table of a mining worker) into this table.
+	Follows the rules of Install: an Undefined placeholder gets replaced by the real definition,
+	otherwise the first definition wins and only its methods, fields and nested classes are completed.
+	The symbols of other are adopted (not copied) and other is left empty.
+*/
+void SymbolTable::Merge(SymbolTable& other) {
+	SymbolMap symbols;
+	std::vector<std::pair<Structure*, Structure*>> merged;		// <own, other's>
+	for (auto& it : other.byID) {
+		assert(it.second->GetClassType() == ClassType::Structure);
+		auto* own = Lookup(it.first);
+		if (!own)
+			own = Install(it.first, it.second);
+		else
+			merged.push_back({ (Structure*)own, (Structure*)it.second });
+		symbols[it.second] = own;
+	}
+
+	for (auto& it : other.byID) {
+		((Structure*)it.second)->Relink(symbols);
+	}
+	for (auto& it : merged) {
+		it.first->Merge(*it.second);
+	}
+
+	other.byID.clear();
+	other.byName.clear();
+}
+
+void SymbolTable::Clear() {
+	byID.clear();
+	byName.clear();
+}
+
+void SymbolTable::Relink(const SymbolMap& symbols) {
+	for (auto& it : byID) {
+		auto found = symbols.find(it.second);
+		if (found != symbols.end())
+			it.second = found->second;
+	}
+}
+
 
 //const Symbol* SymbolTable::Lookup(const std::string& name) const{
 //	auto it = byName.find(name);
@@ -925,15 +1096,15 @@ static Json::Value GetJsonSourceInfo(Symbol* symbol) {
 //	return vec;
 //}
 
-void SymbolTable::AddJsonStructure(dependenciesMining::Structure* structure, Json::Value &json_structure) {
+void SymbolTable::AddJsonStructure(dependenciesMining::Structure* structure, Json::Value &json_structure) const {
 	//Json::Value json_structure;
 
 
 	structure->GetMethods().AddJsonSymbolTable(json_structure["methods"]);
 	structure->GetFields().AddJsonSymbolTable(json_structure["fields"]);
-	const auto bases = structure->GetBases();
+	const auto& bases = structure->GetBases();
 	for (const auto& base : bases) {
-		json_structure["bases"].append(base.second->GetID());
+		json_structure["bases"].append(GetIDString(base.second->GetID()));
 	}
 	//structure->GetBases().AddJsonSymbolTable(json_structure["bases"]); // FIXME need only id
 	structure->GetContains().AddJsonSymbolTable(json_structure["contains"]);
@@ -941,7 +1112,7 @@ void SymbolTable::AddJsonStructure(dependenciesMining::Structure* structure, Jso
 	json_structure["src_info"] = GetJsonSourceInfo(structure);
 }
 
-void SymbolTable::AddJsonMethod(dependenciesMining::Method* method, Json::Value &json_method) {
+void SymbolTable::AddJsonMethod(dependenciesMining::Method* method, Json::Value &json_method) const {
 	//Json::Value json_method;
 
 	/*auto iss = method->GetMemberExpr();
@@ -954,7 +1125,7 @@ void SymbolTable::AddJsonMethod(dependenciesMining::Method* method, Json::Value
 	if (!ret_type)
 		json_method["ret_type"] = "void";
 	else
-		json_method["ret_type"] = ret_type->GetID();
+		json_method["ret_type"] = GetIDString(ret_type->GetID());
 	method->GetArguments().AddJsonSymbolTable(json_method["args"]);
 	method->GetDefinitions().AddJsonSymbolTable(json_method["definitions"]);
 	method->GetTemplateArguments().AddJsonSymbolTable(json_method["template_args"]);
@@ -971,14 +1142,14 @@ void SymbolTable::AddJsonMethod(dependenciesMining::Method* method, Json::Value
 #pragma warning(">>>>>>>>>>>>>> GetMemberExpr() <<<<<<<<<<<<<<<<<")
 }
 
-void SymbolTable::AddJsonDefinition(dependenciesMining::Definition* definition, Json::Value& json_definition) {
+void SymbolTable::AddJsonDefinition(dependenciesMining::Definition* definition, Json::Value& json_definition) const {
 	json_definition["type"] = definition->GetFullType();
 	if (definition->GetAccessType() != AccessType::unknown)
 		json_definition["access"] = definition->GetAccessTypeStr();
 
 }
 
-void SymbolTable::AddJsonSymbolTable(Json::Value& st) {
+void SymbolTable::AddJsonSymbolTable(Json::Value& st) const {
 
 	for (auto& t : byID) {
 		Json::Value new_obj;
@@ -1001,7 +1172,7 @@ void SymbolTable::AddJsonSymbolTable(Json::Value& st) {
 		else
 			assert(0);
 
-		st[t.second->GetID()] = new_obj;
+		st[GetIDString(t.second->GetID())] = new_obj;
 	}
 }
 
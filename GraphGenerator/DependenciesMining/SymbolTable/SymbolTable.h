@@ -6,8 +6,7 @@
 #include <cassert>
 #include <Vector>
 #include "json/writer.h"
-
-#define ID_T std::string 
+#include "SymbolID.h"
 
 namespace dependenciesMining {
 
@@ -85,7 +84,7 @@ namespace dependenciesMining {
 
 	class Symbol {
 	protected:
-		ID_T id = "";
+		ID_T id = NO_ID;
 		std::string name;
 		std::string nameSpace = "";
 		SourceInfo srcInfo;
@@ -119,6 +118,9 @@ namespace dependenciesMining {
 
 	// ----------------------------------------------------------------------------------------
 
+	// old symbol -> symbol that replaces it (used when merging SymbolTables)
+	using SymbolMap = std::unordered_map<const Symbol*, Symbol*>;
+
 	class SymbolTable {
 	private:
 		std::unordered_map<ID_T, Symbol*> byID;
@@ -134,16 +136,19 @@ namespace dependenciesMining {
 		//Symbol* Lookup(const std::string& name);
 		const Symbol* Lookup(const ID_T& id) const;
 		//const Symbol* Lookup(const std::string& name) const;
+		void Merge(SymbolTable& other);
+		void Relink(const SymbolMap& symbols);
+		void Clear();										// forgets the symbols, they are freed with the arena
 
 		void Print();
 		void Print2(int level);
 		Json::Value GetJsonStructure(dependenciesMining::Structure* structure);
 		Json::Value GetJsonMethod(dependenciesMining::Method* method);
 		Json::Value GetJsonDefinition(dependenciesMining::Definition* definition);
-		void AddJsonStructure(dependenciesMining::Structure* structure, Json::Value& json_structure);
-		void AddJsonMethod(dependenciesMining::Method* method, Json::Value& json_method);
-		void AddJsonDefinition(dependenciesMining::Definition* definition, Json::Value& json_definition);
-		void AddJsonSymbolTable(Json::Value& st);
+		void AddJsonStructure(dependenciesMining::Structure* structure, Json::Value& json_structure) const;
+		void AddJsonMethod(dependenciesMining::Method* method, Json::Value& json_method) const;
+		void AddJsonDefinition(dependenciesMining::Definition* definition, Json::Value& json_definition) const;
+		void AddJsonSymbolTable(Json::Value& st) const;
 		Json::Value GetJsonSymbolTable(void);
 		void Accept(STVisitor* visitor);
 		void Accept(STVisitor* visitor) const;
@@ -172,9 +177,10 @@ namespace dependenciesMining {
 		Template() = default;
 
 		Parent_T* GetParent() const;
-		SymbolTable GetArguments() const;
+		const SymbolTable& GetArguments() const;
 		void SetParent(Parent_T* structure); 
 		Symbol* InstallArguments(const ID_T& id, Structure* structure);
+		void Relink(const SymbolMap& symbols);
 	};
 
 	// ----------------------------------------------------------------------------------------
@@ -196,6 +202,7 @@ namespace dependenciesMining {
 		std::string GetFullType() const;
 		void SetType(Structure* structure);
 		void SetFullType(const std::string& type);
+		void Relink(const SymbolMap& symbols);
 	};
 
 	#define Value_mem_t "Value"
@@ -225,6 +232,7 @@ namespace dependenciesMining {
 			void SetName(const std::string& name);
 			void SetLocEnd(const SourceInfo& locEnd);
 			void SetType(Structure* type);
+			void Relink(const SymbolMap& symbols);
 		};
 
 		class MemberExpr {
@@ -236,12 +244,13 @@ namespace dependenciesMining {
 			MemberExpr() = default;
 			MemberExpr(std::string expr, SourceInfo locEnd, std::string fileName, int line, int column) : expr(expr), locEnd(locEnd), srcInfo(SourceInfo(fileName, line, column)) {};
 			std::string GetExpr() const;
-			std::vector<Member> GetMembers() const;
+			const std::vector<Member>& GetMembers() const;
 			SourceInfo GetLocEnd() const;
 			SourceInfo GetSourceInfo() const;
 			void SetExpr(std::string expr);
 			void SetLocEnd(SourceInfo locEnd);
 			void InsertMember(Member member);
+			void Relink(const SymbolMap& symbols);
 		};
 
 	private:
@@ -257,7 +266,8 @@ namespace dependenciesMining {
 		int loops = 0;
 		int max_scope_depth = 0;
 		int line_count = 0;
-		bool is_virtual;
+		bool is_virtual = false;
+		bool bodyMined = false;										// the metrics and MemberExprs of its body are set (first TU wins)
 	public:
 		Method() : Symbol(ClassType::Method) {};
 		Method(const ID_T& id, const std::string& name, const std::string& nameSpace = "") : Symbol(id, name, nameSpace, ClassType::Method) {};
@@ -268,10 +278,10 @@ namespace dependenciesMining {
 		std::string GetMethodTypeAsString() const;
 		Structure* GetReturnType() const;
 
-		SymbolTable GetArguments() const;
-		SymbolTable GetDefinitions() const;
-		SymbolTable GetTemplateArguments() const;
-		std::map<std::string, MemberExpr> GetMemberExpr() const;
+		const SymbolTable& GetArguments() const;
+		const SymbolTable& GetDefinitions() const;
+		const SymbolTable& GetTemplateArguments() const;
+		const std::map<std::string, MemberExpr>& GetMemberExpr() const;
 		int GetLiterals() const;
 		int GetStatements() const;
 		int GetBranches() const;
@@ -289,6 +299,7 @@ namespace dependenciesMining {
 		void SetMaxScopeDepth(int max_scope_depth);
 		void SetLineCount(int line_count);
 		void SetVirtual(bool is_virtual);
+		void SetBodyMined(bool bodyMined);
 
 		void InstallArg(const ID_T& id, const Definition& definition);
 		void InstallDefinition(const ID_T& id, const Definition& definition);
@@ -297,6 +308,9 @@ namespace dependenciesMining {
 		void InsertMemberExpr(MemberExpr const& memberExpr, Member const& member, const std::string& locBegin);
 		void UpdateMemberExpr(MemberExpr const& memberExpr, const std::string& locBegin);
 
+		void Merge(Method& other);
+		void Relink(const SymbolMap& symbols);
+
 		bool IsConstructor () const;
 		bool IsDestructor() const;
 		bool IsUserMethod() const;
@@ -306,6 +320,7 @@ namespace dependenciesMining {
 		bool IsTemplateInstantiationSpecialization() const;
 		bool IsTrivial() const;
 		bool IsVirtual() const;
+		bool IsBodyMined() const;
 	};
 
 	// ----------------------------------------------------------------------------------------
@@ -329,18 +344,19 @@ namespace dependenciesMining {
 		Structure(const ID_T& id, const std::string& name, const std::string& nameSpace, StructureType structureType, const std::string& fileName, int line, int column)
 			: Symbol(id, name, nameSpace, ClassType::Structure, fileName, line, column), structureType(structureType) {};
 		Structure(const Structure& s); 
+		Structure& operator=(const Structure& s) = default;		// every member (an Undefined placeholder replaced by its definition)
 		
 		StructureType GetStructureType() const;
 		std::string GetStructureTypeAsString() const;
 		Structure* GetTemplateParent() const;
 		Structure* GetNestedParent() const;
 
-		SymbolTable GetMethods() const; 
-		SymbolTable GetFields() const; 
-		SymbolTable GetBases() const; 
-		SymbolTable GetContains() const;
-		SymbolTable GetFriends() const;
-		SymbolTable GetTemplateArguments() const; 
+		const SymbolTable& GetMethods() const; 
+		const SymbolTable& GetFields() const; 
+		const SymbolTable& GetBases() const; 
+		const SymbolTable& GetContains() const;
+		const SymbolTable& GetFriends() const;
+		const SymbolTable& GetTemplateArguments() const; 
 
 		void SetStructureType(const StructureType& structureType);
 		void SetTemplateParent(Structure* structure);
@@ -355,6 +371,10 @@ namespace dependenciesMining {
 		Symbol* InstallFriend(const ID_T& id, Structure* structure);
 		Symbol* InstallTemplateSpecializationArguments(const ID_T& id, Structure* structure);
 
+		void Merge(Structure& other);
+		void MergeMembers(Structure& other);
+		void Relink(const SymbolMap& symbols);
+
 		bool IsTemplateDefinition() const;
 		bool IsTemplateFullSpecialization() const;
 		bool IsTemplateInstantiationSpecialization() const;
@@ -0,0 +1,84 @@
+#include "TUTimings.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+
+using namespace dependenciesMining;
+
+/*
+	File layout, one line per TU:
+		<ms> <absolute path>
+*/
+
+std::string TUTimings::GetKey(const std::string& file) {
+	std::error_code error;
+	auto absolute = std::filesystem::absolute(file, error);
+	if (error)
+		return file;
+	return absolute.lexically_normal().generic_string();
+}
+
+bool TUTimings::Load(const std::string& path) {
+	std::ifstream in(path);
+	if (!in.is_open())
+		return false;
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream entry(line);
+		double ms;
+		std::string file;
+		if (entry >> ms && std::getline(entry >> std::ws, file) && file != "")
+			durations[file] = ms;
+	}
+	return true;
+}
+
+bool TUTimings::Save(const std::string& path) const {
+	std::vector<std::pair<std::string, double>> sorted(durations.begin(), durations.end());
+	std::sort(sorted.begin(), sorted.end());
+	std::string tmpPath = path + ".tmp";
+	{
+		std::ofstream out(tmpPath);
+		for (const auto& it : sorted)
+			out << it.second << " " << it.first << "\n";
+		if (!out)
+			return false;
+	}
+	std::error_code error;
+	std::filesystem::rename(tmpPath, path, error);
+	return !error;
+}
+
+void TUTimings::Set(const std::string& file, double ms) {
+	durations[GetKey(file)] = ms;
+}
+
+std::vector<size_t> TUTimings::GetLongestFirstOrder(const std::vector<std::string>& files) const {
+	std::vector<double> known(files.size(), -1);
+	std::vector<double> sizes(files.size(), 0);
+	double knownMs = 0, knownBytes = 0;
+	for (size_t i = 0; i < files.size(); ++i) {
+		std::error_code error;
+		auto size = std::filesystem::file_size(files[i], error);
+		sizes[i] = error ? 0 : (double)size;
+		auto it = durations.find(GetKey(files[i]));
+		if (it != durations.end()) {
+			known[i] = it->second;
+			knownMs += it->second;
+			knownBytes += sizes[i];
+		}
+	}
+
+	// A TU without history is expected to take as long per byte (of its main file) as the TUs with
+	double msPerByte = (knownMs > 0 && knownBytes > 0) ? knownMs / knownBytes : 1;
+	std::vector<double> expected(files.size());
+	for (size_t i = 0; i < files.size(); ++i)
+		expected[i] = known[i] >= 0 ? known[i] : sizes[i] * msPerByte;
+
+	std::vector<size_t> order(files.size());
+	for (size_t i = 0; i < order.size(); ++i)
+		order[i] = i;
+	std::stable_sort(order.begin(), order.end(), [&expected](size_t a, size_t b) { return expected[a] > expected[b]; });
+	return order;
+}
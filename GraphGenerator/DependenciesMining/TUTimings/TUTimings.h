@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/*
+	How long each TU took to mine (parse and match) on the previous runs, kept in a file next to the ST.
+	The parallel runs dispatch the TUs longest first, so that the huge TUs do not start last and keep
+	a single worker busy after the others are done. TUs without a duration (new, or never mined in parallel)
+	are estimated from their size.
+	Only the dispatch order changes: the tables of the TUs are still merged in the order of the files.
+*/
+
+namespace dependenciesMining {
+
+	class TUTimings {
+	private:
+		std::unordered_map<std::string, double> durations;		// <absolute path, ms>
+
+		static std::string GetKey(const std::string& file);
+	public:
+		// A missing file is an empty history (returns false)
+		bool Load(const std::string& path);
+		bool Save(const std::string& path) const;
+
+		// Replaces the loaded duration of the TU, the TUs not mined by this run keep theirs
+		void Set(const std::string& file, double ms);
+
+		// Indices of files, the (expected) longest TU first
+		std::vector<size_t> GetLongestFirstOrder(const std::vector<std::string>& files) const;
+	};
+}
@@ -0,0 +1,52 @@
+#include "CSRGraph.h"
+#include "GraphVisitor.h"
+
+using namespace graph;
+
+namespace {
+
+	class NodesCollector : public GraphVisitor {
+	public:
+		std::vector<Node*> nodes;
+		virtual void VisitNode(Node* node) { nodes.push_back(node); }
+		virtual void VisitEdge(Edge*) {}
+	};
+}
+
+CSRGraph::CSRGraph(const Graph& graph) {
+	NodesCollector collector;
+	graph.Accept(&collector);
+	nodes = std::move(collector.nodes);
+
+	byID.reserve(nodes.size());
+	size_t edgesSize = 0;
+	for (Index i = 0; i < nodes.size(); ++i) {
+		byID[nodes[i]->GetID()] = i;
+		edgesSize += nodes[i]->EdgesSize();
+	}
+
+	std::vector<Edge*> allEdges;
+	allEdges.reserve(edgesSize);
+	offsets.reserve(nodes.size() + 1);
+	offsets.push_back(0);
+	for (auto* node : nodes) {
+		node->ForEachEdge([&allEdges](Edge* edge) {
+			allEdges.push_back(edge);
+			});
+		offsets.push_back((Index)allEdges.size());
+	}
+
+	edges.reserve(allEdges.size());
+	cardinalities.reserve(allEdges.size());
+	for (auto* edge : allEdges) {
+		auto to = GetNode(edge->GetTo()->GetID());
+		assert(to != NoNode);										// every Node of the graph is added to it
+		edges.push_back(to);
+		cardinalities.push_back(edge->GetDependencies());
+	}
+}
+
+CSRGraph::Index CSRGraph::GetNode(ID_T id) const {
+	auto it = byID.find(id);
+	return it != byID.end() ? it->second : NoNode;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include "Graph.h"
+
+/*
+	Immutable, compressed sparse row form of a finished Graph, for traversals:
+		nodes				node i (in the order of Graph::Accept)
+		offsets				the edges of node i are [offsets[i], offsets[i + 1])
+		edges				target node of every edge
+		cardinalities		the Edge::Dependencies of every edge (cardinality per DependencyType, 0: no such dependency)
+	The node data stay in the Nodes of the Graph (they are not copied).
+*/
+
+namespace graph {
+
+	class CSRGraph {
+	public:
+		using Index = uint32_t;
+		static constexpr Index NoNode = (Index)-1;
+
+	private:
+		std::vector<Node*> nodes;
+		std::vector<Index> offsets;
+		std::vector<Index> edges;
+		std::vector<Edge::Dependencies> cardinalities;
+		std::unordered_map<ID_T, Index> byID;
+
+	public:
+		CSRGraph(const Graph& graph);
+
+		Index NodesSize() const { return (Index)nodes.size(); }
+		Index EdgesSize() const { return (Index)edges.size(); }
+
+		Index GetNode(ID_T id) const;							// NoNode if there is no such node
+		ID_T GetID(Index node) const { return nodes[node]->GetID(); }
+		const StructureData& GetData(Index node) const { return nodes[node]->GetData(); }
+
+		Index EdgesBegin(Index node) const { return offsets[node]; }
+		Index EdgesEnd(Index node) const { return offsets[node + 1]; }
+		Index GetTo(Index edge) const { return edges[edge]; }
+		Edge::Cardinality GetCardinality(Index edge, Edge::DependencyType depType) const { return cardinalities[edge][(unsigned)depType]; }
+
+		// f(Index edge, Index to)
+		template <typename Tfunc>
+		void ForEachEdge(Index node, const Tfunc& f) const {
+			for (Index edge = offsets[node]; edge < offsets[node + 1]; ++edge)
+				f(edge, edges[edge]);
+		}
+
+		// f(DependencyType depType, Cardinality card), the dependency types of the edge only (sorted by name)
+		template <typename Tfunc>
+		void ForEachDependency(Index edge, const Tfunc& f) const {
+			const auto& card = cardinalities[edge];
+			for (unsigned i = 0; i < DependencyTypesCount; ++i) {
+				if (card[i])
+					f((Edge::DependencyType)i, card[i]);
+			}
+		}
+	};
+}
@@ -1,5 +1,6 @@
 #include "Graph.h"
 #include "GraphVisitor.h"
+#include "Arena.h"
 
 using namespace graph;
 
@@ -13,26 +14,19 @@ Node* Edge::GetTo() const {
 	return to; 
 }
 
-Edge::Cardinality Edge::GetCardinality(const DependencyType& depType) const {
-	auto it = dependencies.find(depType);
-	if (it != dependencies.end()) {
-		return it->second; 
-	}
-	return 0;
+Edge::Cardinality Edge::GetCardinality(DependencyType depType) const {
+	assert(depType != DependencyType::Undefined);
+	return dependencies[(unsigned)depType];
 }
 
-std::map<Edge::DependencyType, Edge::Cardinality> Edge::GetDependencies() const {
+const Edge::Dependencies& Edge::GetDependencies() const {
 	return dependencies;
 }
 
 
-void Edge::AddDependency(const DependencyType& depType, Edge::Cardinality card) {
-	if (dependencies.find(depType) != dependencies.end()) {
-		dependencies[depType] += card;
-	}
-	else {
-		dependencies[depType] = card;
-	}
+void Edge::AddDependency(DependencyType depType, Edge::Cardinality card) {
+	assert(depType != DependencyType::Undefined);
+	dependencies[(unsigned)depType] += card;
 }
 
 
@@ -44,13 +38,17 @@ Node::Node(const Node& node) {
 }
 
 ID_T Node::GetID() const {
-	return data.Get("id").ToString(); 
+	return data.id;
 }
 
-untyped::Object& Node::GetData() {
+StructureData& Node::GetData() {
 	return data; 
 }
 
+const StructureData& Node::GetData() const {
+	return data;
+}
+
 unsigned Node::EdgesSize() const {
 	return outEdges.size();
 }
@@ -60,15 +58,17 @@ void Node::AddEdge(Edge* edge) {
 	byDestinationID[edge->GetTo()->GetID()] = edge;
 }
 
-void Node::AddEdge(Node* to, const Edge::DependencyType& depType, Edge::Cardinality card) {
-	if (byDestinationID.find(to->GetID()) != byDestinationID.end()) {
-		byDestinationID[to->GetID()]->AddDependency(depType, card);
+void Node::AddEdge(Node* to, Edge::DependencyType depType, Edge::Cardinality card) {
+	auto toID = to->GetID();
+	auto it = byDestinationID.find(toID);
+	if (it != byDestinationID.end()) {
+		it->second->AddDependency(depType, card);
 	}
 	else {
-		Edge* edge = new Edge(to);
+		Edge* edge = arena::New<Edge>(arena::Kind::Edge, to);
 		edge->AddDependency(depType, card);
 		outEdges.push_back(edge);
-		byDestinationID[to->GetID()] = edge;
+		byDestinationID[toID] = edge;
 	}
 }
 
@@ -88,7 +88,7 @@ void Graph::AddNode(Node* node) {
 }
 
 
-void Graph::AddEdge(Node* from, Node* to, const Edge::DependencyType& depType, Edge::Cardinality card) {
+void Graph::AddEdge(Node* from, Node* to, Edge::DependencyType depType, Edge::Cardinality card) {
 	from->AddEdge(to, depType, card);
 }
 
@@ -1,40 +1,104 @@
 #pragma once
+#include <array>
 #include <map>
 #include <list>
 #include <set>
 #include <string>
 #include "SymbolTable.h"
-#include "uobject_untyped.h"
+#include "NodeData.h"
 
 using namespace dependenciesMining; 
 
-#define Undefined_dep_t "Undefined"
+#define Undefined_dep_t graph::DependencyType::Undefined
 
 namespace graph {
 
     class Node; 
     class GraphVisitor;
 
+    // Sorted by name: the serializers write the dependency types in this order (as json object keys)
+    enum class DependencyType : unsigned {
+        ClassField,
+        ClassTemplateArg,
+        ClassTemplateParent,
+        Friend,
+        Inherit,
+        MemberExpr,
+        MethodArg,
+        MethodDefinition,
+        MethodReturn,
+        MethodTemplateArg,
+        NestedClass,
+        Count,
+        Undefined = Count
+    };
+
+    constexpr unsigned DependencyTypesCount = (unsigned)DependencyType::Count;
+
+    constexpr const char* dependencyTypeNames[DependencyTypesCount + 1] = {
+        "ClassField",
+        "ClassTemplateArg",
+        "ClassTemplateParent",
+        "Friend",
+        "Inherit",
+        "MemberExpr",
+        "MethodArg",
+        "MethodDefinition",
+        "MethodReturn",
+        "MethodTemplateArgs",
+        "NestedClass",
+        "Undefined"
+    };
+
+    constexpr const char* GetDependencyTypeName(DependencyType depType) {
+        return dependencyTypeNames[(unsigned)depType];
+    }
+
+    constexpr bool AreDependencyTypeNamesSorted() {
+        for (unsigned i = 1; i < DependencyTypesCount; ++i) {
+            const char* a = dependencyTypeNames[i - 1];
+            const char* b = dependencyTypeNames[i];
+            while (*a && *a == *b) {
+                ++a;
+                ++b;
+            }
+            if ((unsigned char)*a >= (unsigned char)*b)
+                return false;
+        }
+        return true;
+    }
+    static_assert(AreDependencyTypeNamesSorted(), "DependencyType must be sorted by name");
+
     class Edge {
     public:
       using Cardinality = unsigned;
-      using DependencyType = std::string;
+      using DependencyType = graph::DependencyType;
+      using Dependencies = std::array<Cardinality, DependencyTypesCount>;		// indexed by DependencyType
     private:
-        std::map<DependencyType, Cardinality> dependencies;
+        Dependencies dependencies = {};
         Node* to = nullptr;
     public:
         Edge(Node* to) : to(to) { assert(to); };
         Edge(const Edge& edge);
 
         Node* GetTo() const ;
-        Cardinality GetCardinality(const DependencyType& depType) const;
-        std::map<DependencyType, Cardinality> GetDependencies() const;
-        void AddDependency(const DependencyType& depType, Cardinality card = 1);
+        Cardinality GetCardinality(DependencyType depType) const;
+        const Dependencies& GetDependencies() const;
+        void AddDependency(DependencyType depType, Cardinality card = 1);
+
+        // f(DependencyType depType, Cardinality card), the dependency types of the edge only
+        template <typename Tfunc>
+        void ForEachDependency(const Tfunc& f) const {
+            for (unsigned i = 0; i < DependencyTypesCount; ++i) {
+                if (dependencies[i])
+                    f((DependencyType)i, dependencies[i]);
+            }
+        }
     };
 
 
     class Node {
-        untyped::Object data;
+        StructureData data;
         std::list<Edge*> outEdges;
         std::map<ID_T, Edge*> byDestinationID; 
     public:
@@ -42,10 +106,11 @@ namespace graph {
         Node(const Node& node);
 
         ID_T GetID() const;
-        untyped::Object& GetData();
+        StructureData& GetData();
+        const StructureData& GetData() const;
         unsigned EdgesSize() const;
         void AddEdge(Edge* edge);
-        void AddEdge(Node* to, const Edge::DependencyType& depType, Edge::Cardinality card = 1);
+        void AddEdge(Node* to, Edge::DependencyType depType, Edge::Cardinality card = 1);
         template <typename Tfunc>
         void ForEachEdge(const Tfunc& f) const {
             for (auto& i : outEdges)
@@ -62,7 +127,7 @@ namespace graph {
 
         Node* GetNode(ID_T id) const;
         void AddNode(Node* node);
-        void AddEdge(Node* from, Node* to, const Edge::DependencyType& depType, Edge::Cardinality card = 1);
+        void AddEdge(Node* from, Node* to, Edge::DependencyType depType, Edge::Cardinality card = 1);
 
         void Accept(GraphVisitor* visitor);
         void Accept(GraphVisitor* visitor) const;
@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+
+/*
+	Typed payloads of the graph Nodes (a Node holds the StructureData of its structure), filled by
+	graphGeneration and read by graphToJson. The IDs are kept as numbers (NO_ID: none), they are
+	materialized to strings only on output.
+*/
+
+namespace graph {
+
+	struct DefinitionData {
+		ID_T id = NO_ID;
+		std::string name;
+		std::string nameSpace;
+		dependenciesMining::SourceInfo srcInfo;
+		ID_T type = NO_ID;
+	};
+
+	struct MemberData {
+		std::string name;
+		ID_T type = NO_ID;
+		std::string memberType;
+		dependenciesMining::SourceInfo locEnd;
+	};
+
+	struct MemberExprData {
+		std::string expr;
+		dependenciesMining::SourceInfo srcInfo;
+		std::vector<MemberData> members;
+	};
+
+	struct MethodData {
+		ID_T id = NO_ID;
+		std::string name;
+		std::string nameSpace;
+		dependenciesMining::SourceInfo srcInfo;
+		std::string methodType;
+		ID_T returnType = NO_ID;
+		std::vector<DefinitionData> arguments;
+		std::vector<DefinitionData> definitions;
+		std::vector<ID_T> templateArguments;
+		std::vector<MemberExprData> memberExprs;			// in the order of the Method memberExprs (by location)
+	};
+
+	struct StructureData {
+		ID_T id = NO_ID;
+		std::string name;
+		std::string nameSpace;
+		dependenciesMining::SourceInfo srcInfo;
+		std::string structureType;
+		ID_T templateParent = NO_ID;
+		ID_T nestedParent = NO_ID;
+		std::vector<ID_T> bases;
+		std::vector<ID_T> friends;
+		std::vector<ID_T> templateArguments;
+		std::vector<DefinitionData> fields;
+		std::vector<MethodData> methods;
+	};
+}
@@ -1,4 +1,5 @@
 #include "GraphGeneration.h"
+#include "Arena.h"
 
 using namespace dependenciesMining; 
 using namespace graph;
@@ -21,33 +22,26 @@ void GraphGenerationSTVisitor::VisitStructure(Structure* s) {
 	
 	Node* oldCurrNode = currNode;
 	Edge::DependencyType oldCurrDepType = currDepType;
-	currNode = new Node();
-	untyped::Object& nodeData = currNode->GetData();
+	currNode = arena::New<Node>(arena::Kind::Node);
+	StructureData& nodeData = currNode->GetData();
 
 	// Symbol 
-	nodeData.Set("id", s->GetID());
-	nodeData.Set("name", s->GetName());
-	nodeData.Set("namespace", s->GetNamespace());
-
-	untyped::Object srcInfo;
-	srcInfo.Set("fileName", s->GetSourceInfo().GetFileName());
-	srcInfo.Set("line", (double)s->GetSourceInfo().GetLine());
-	srcInfo.Set("column", (double)s->GetSourceInfo().GetColumn());
-	nodeData.Set("srcInfo", srcInfo);
-
-	nodeData.Set("classType", s->GetClassTypeAsString());
+	nodeData.id = s->GetID();
+	nodeData.name = s->GetName();
+	nodeData.nameSpace = s->GetNamespace();
+	nodeData.srcInfo = s->GetSourceInfo();
 
 	graph.AddNode(currNode);
 
 	// Structure
-	nodeData.Set("structureType", s->GetStructureTypeAsString());
+	nodeData.structureType = s->GetStructureTypeAsString();
 
 	if (s->GetTemplateParent()) {
 		auto* templateParent = s->GetTemplateParent();
 		if (!templateParent->IsUndefined()) {
 			currDepType = ClassTemplateParent_dep_t;
 			VisitStructure(static_cast<Structure*>(templateParent));
-			nodeData.Set("templateParent", templateParent->GetID());
+			nodeData.templateParent = templateParent->GetID();
 		}
 	}
 
@@ -56,68 +50,55 @@ void GraphGenerationSTVisitor::VisitStructure(Structure* s) {
 		if (!nestedParent->IsUndefined()) {
 			currDepType = NestedClass_dep_t;
 			VisitStructure(static_cast<Structure*>(nestedParent));
-			nodeData.Set("nestedParent", nestedParent->GetID());
+			nodeData.nestedParent = nestedParent->GetID();
 		}
 	}
 
-	untyped::Object basesObj;
 	currDepType = Inherit_dep_t;
-	double index = 0;
 	for (auto& it : s->GetBases()) {
 		auto* base = it.second;
 		if (!((Structure*)base)->IsUndefined()) {
 			VisitStructure(static_cast<Structure*>(base));
-			basesObj.Set(index++, base->GetID());
+			nodeData.bases.push_back(base->GetID());
 		}
 	}
-	nodeData.Set("bases", basesObj);
 
-	untyped::Object friendsObj;
-	index = 0;
 	currDepType = Friend_dep_t;
 	for (auto& it : s->GetFriends()) {
 		auto* friend_ = it.second;
 		if (!((Structure*)friend_)->IsUndefined()) {
 			VisitStructure(static_cast<Structure*>(friend_));
-			friendsObj.Set(index++, friend_->GetID());
+			nodeData.friends.push_back(friend_->GetID());
 		}
 	}
-	nodeData.Set("friends", friendsObj);
 
-	untyped::Object templArgsObj;
-	index = 0;
 	currDepType = ClassTemplateArg_dep_t;
 	for (auto& it : s->GetTemplateArguments()) {
 		auto* templArg = it.second;
 		if (!((Structure*)templArg)->IsUndefined()) {
 			VisitStructure(static_cast<Structure*>(templArg));
-			templArgsObj.Set(index++, templArg->GetID());
+			nodeData.templateArguments.push_back(templArg->GetID());
 		}
 	}
-	nodeData.Set("templateArguments", templArgsObj);
 		
-	untyped::Object fieldsObj;
 	currDepType = ClassField_dep_t;
 	for (auto& it : s->GetFields()) {
 		auto* field = it.second;
 		if(((Definition*)field)->isStructure()){
 			if (!((Definition*)field)->GetType()->IsUndefined()) {
 				VisitDefinition(static_cast<Definition*>(field));
-				fieldsObj.Set(it.first, innerObj);
+				nodeData.fields.push_back(std::move(innerDefinition));
 			}
 		}
 	}
-	nodeData.Set("fields", fieldsObj);
 
-	untyped::Object methodsObj;
 	for (auto& it : s->GetMethods()) {
 		auto* method = it.second;
 		if (((Method*)method)->IsTrivial())						// Ignore the Trivial methods that compiler creates automatically
 			continue;
 		VisitMethod(static_cast<Method*>(method));
-		methodsObj.Set(it.first, innerObj);
+		nodeData.methods.push_back(std::move(innerMethod));
 	}
-	nodeData.Set("methods", methodsObj);
 
 	if (oldCurrNode) {
 		assert(oldCurrDepType != Undefined_dep_t);
@@ -131,105 +112,80 @@ void GraphGenerationSTVisitor::VisitStructure(Structure* s) {
 
 void GraphGenerationSTVisitor::VisitMethod(Method* s) {
 	Edge::DependencyType oldCurrDepType = currDepType;
-	untyped::Object data;
+	MethodData data;
 
 	// Symbol 
-	data.Set("id", s->GetID());
-	data.Set("name", s->GetName());
-	data.Set("namespace", s->GetNamespace());
-
-	untyped::Object srcInfo;
-	srcInfo.Set("fileName", s->GetSourceInfo().GetFileName());
-	srcInfo.Set("line", (double)s->GetSourceInfo().GetLine());
-	srcInfo.Set("column", (double)s->GetSourceInfo().GetColumn());
-	data.Set("srcInfo", srcInfo);
-	data.Set("classType", s->GetClassTypeAsString());
+	data.id = s->GetID();
+	data.name = s->GetName();
+	data.nameSpace = s->GetNamespace();
+	data.srcInfo = s->GetSourceInfo();
 
 	// Method
-	data.Set("methodType", s->GetMethodTypeAsString());
+	data.methodType = s->GetMethodTypeAsString();
 
 	if (s->GetReturnType()) {
 		auto* returnType = s->GetReturnType();
 		if (!returnType->IsUndefined()) {
 			currDepType = MethodReturn_dep_t;
 			VisitStructure(static_cast<Structure*>(returnType));
-			data.Set("returnType", returnType->GetID());
+			data.returnType = returnType->GetID();
 		}
 	}
 	
-	untyped::Object argsObj;
 	currDepType = MethodArg_dep_t;
 	for (auto& it : s->GetArguments()) {
 		auto* arg = it.second;
 		if (((Definition*)arg)->isStructure()) {
 			if (!((Definition*)arg)->GetType()->IsUndefined()) {
 				VisitDefinition(static_cast<Definition*>(arg));
-				argsObj.Set(it.first, innerObj);
+				data.arguments.push_back(std::move(innerDefinition));
 			}
 		}
 	}
-	data.Set("arguments", argsObj);
 
-	untyped::Object defsObj;
 	currDepType = MethodDefinition_dep_t;
 	for (auto& it : s->GetDefinitions()) {
 		auto* def = it.second;
 		if (((Definition*)def)->isStructure()) {
 			if (!((Definition*)def)->GetType()->IsUndefined()) {
 				VisitDefinition(static_cast<Definition*>(def));
-				defsObj.Set(it.first, innerObj);
+				data.definitions.push_back(std::move(innerDefinition));
 			}
 		}
 	}
-	data.Set("definitions", defsObj);
 
-	untyped::Object templArgsObj;
-	double index = 0;
 	currDepType = MethodTemplateArg_dep_t;
 	for (auto& it : s->GetTemplateArguments()) {
 		auto* templArg = it.second;
 		if (!((Structure*)templArg)->IsUndefined()) {
 			VisitStructure(static_cast<Structure*>(templArg));
-			templArgsObj.Set(index++, templArg->GetID());
+			data.templateArguments.push_back(templArg->GetID());
 		}
 	}
-	data.Set("templateArguments", templArgsObj);
 
 	// memberexpr
-	untyped::Object memberExprsObj; 
 	currDepType = MemberExpr_dep_t;
-	for (auto it : s->GetMemberExpr()) {
-		auto expr = it.second;
-		untyped::Object memberExprObj;
+	for (const auto& it : s->GetMemberExpr()) {
+		const auto& expr = it.second;
 
 		if (!expr.GetMembers().size())
 			continue;
 
-		memberExprObj.Set("expr", expr.GetExpr());
-		untyped::Object srcInfo;
-		srcInfo.Set("fileName", expr.GetSourceInfo().GetFileName());
-		srcInfo.Set("line", (double)expr.GetSourceInfo().GetLine());
-		srcInfo.Set("column", (double)expr.GetSourceInfo().GetColumn());
-		memberExprObj.Set("srcInfo", srcInfo);
-
-		untyped::Object membersObj;
-		double index2 = 0;
-		for (auto it2 : expr.GetMembers()) {
-			auto member = it2;
+		MemberExprData memberExprData;
+		memberExprData.expr = expr.GetExpr();
+		memberExprData.srcInfo = expr.GetSourceInfo();
+
+		for (const auto& it2 : expr.GetMembers()) {
+			const auto& member = it2;
 			auto* memberType = it2.GetType();
 			if (!memberType->IsUndefined()) {
-				untyped::Object memberObj;
+				MemberData memberData;
 
-				memberObj.Set("name", member.GetName());
+				memberData.name = member.GetName();
 				assert(it2.GetType());
-				memberObj.Set("type", memberType->GetID());
-				memberObj.Set("memberType", member.GetMemberType());
-
-				untyped::Object locEnd;
-				locEnd.Set("fileName", member.GetLocEnd().GetFileName());
-				locEnd.Set("line", (double)member.GetLocEnd().GetLine());
-				locEnd.Set("column", (double)member.GetLocEnd().GetColumn());
-				memberObj.Set("locEnd", locEnd);
+				memberData.type = memberType->GetID();
+				memberData.memberType = member.GetMemberType();
+				memberData.locEnd = member.GetLocEnd();
 
 				/*if (member.GetMemberType() == Value_mem_t)
 					currDepType = MemberExpr_Value_dep_t;
@@ -239,18 +195,14 @@ void GraphGenerationSTVisitor::VisitMethod(Method* s) {
 					currDepType = MemberExpr_MethodDefinition_dep_t;*/
 
 				VisitStructure(static_cast<Structure*>(memberType));
-				membersObj.Set(index2++, memberObj);
+				memberExprData.members.push_back(std::move(memberData));
 			}
-			memberExprObj.Set("members", membersObj);				
 		}
 
-		memberExprsObj.Set(it.first, memberExprObj);
+		data.memberExprs.push_back(std::move(memberExprData));
 	}
-	data.Set("memberExprs", memberExprsObj);
 
-	innerObj.Clear();
-	innerObj = data;
-	data.Clear();
+	innerMethod = std::move(data);
 	currDepType = oldCurrDepType;
 }
 
@@ -263,28 +215,19 @@ void GraphGenerationSTVisitor::VisitDefinition(Definition* s) {
 		assert(0);
 
 	VisitStructure(typeStruct);
-	Node* node = graph.GetNode(typeStruct->GetID());
 
-	untyped::Object data;
+	DefinitionData data;
 
 	// Symbol 
-	data.Set("id", s->GetID());
-	data.Set("name", s->GetName());
-	data.Set("namespace", s->GetNamespace());
-
-	untyped::Object srcInfo;
-	srcInfo.Set("fileName", s->GetSourceInfo().GetFileName());
-	srcInfo.Set("line", (double)s->GetSourceInfo().GetLine());
-	srcInfo.Set("column", (double)s->GetSourceInfo().GetColumn());
-	data.Set("srcInfo", srcInfo);
-	data.Set("classType", s->GetClassTypeAsString());
+	data.id = s->GetID();
+	data.name = s->GetName();
+	data.nameSpace = s->GetNamespace();
+	data.srcInfo = s->GetSourceInfo();
 
 	// Definition
-	data.Set("type", typeStruct->GetID());
+	data.type = typeStruct->GetID();
 
-	innerObj.Clear();
-	innerObj = data;
-	data.Clear();
+	innerDefinition = std::move(data);
 	currDepType = oldCurrDepType;
 }
 
@@ -3,21 +3,21 @@
 #include "STVisitor.h"
 #include "Graph.h"
 
-// Dependency Types
-#define Inherit_dep_t "Inherit"
-#define Friend_dep_t "Friend"
-#define NestedClass_dep_t "NestedClass"
-#define ClassField_dep_t "ClassField"
-#define ClassTemplateParent_dep_t "ClassTemplateParent"
-#define ClassTemplateArg_dep_t "ClassTemplateArg"
-#define MethodReturn_dep_t "MethodReturn"
-#define MethodArg_dep_t "MethodArg"
-#define MethodDefinition_dep_t "MethodDefinition"
-#define MemberExpr_dep_t "MemberExpr"
+// Dependency Types (names in graph::dependencyTypeNames)
+#define Inherit_dep_t graph::DependencyType::Inherit
+#define Friend_dep_t graph::DependencyType::Friend
+#define NestedClass_dep_t graph::DependencyType::NestedClass
+#define ClassField_dep_t graph::DependencyType::ClassField
+#define ClassTemplateParent_dep_t graph::DependencyType::ClassTemplateParent
+#define ClassTemplateArg_dep_t graph::DependencyType::ClassTemplateArg
+#define MethodReturn_dep_t graph::DependencyType::MethodReturn
+#define MethodArg_dep_t graph::DependencyType::MethodArg
+#define MethodDefinition_dep_t graph::DependencyType::MethodDefinition
+#define MemberExpr_dep_t graph::DependencyType::MemberExpr
 //#define MemberExpr_Value_dep_t "MemberExprValue"
 //#define MemberExpr_ClassField_dep_t "MemberExprClassField"
 //#define MemberExpr_MethodDefinition_dep_t "MemberExprMethodDefinition"
-#define MethodTemplateArg_dep_t "MethodTemplateArgs"
+#define MethodTemplateArg_dep_t graph::DependencyType::MethodTemplateArg
 
 using namespace graph;
 using namespace dependenciesMining;
@@ -27,7 +27,8 @@ namespace graphGeneration {
 	class GraphGenerationSTVisitor : public STVisitor {
 		Graph graph;
 		Node* currNode = nullptr;
-		untyped::Object innerObj;
+		DefinitionData innerDefinition;							// the result of VisitDefinition
+		MethodData innerMethod;									// the result of VisitMethod
 		Edge::DependencyType currDepType = Undefined_dep_t;
 	public:
 		virtual void VisitStructure(Structure* s);
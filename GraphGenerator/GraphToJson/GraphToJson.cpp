@@ -1,190 +1,147 @@
 #include "GraphToJson.h"
-#define TO_ID_T() ToString()
 
 using namespace graphToJson;
 
-Json::Value GraphToJsonVisitor::StructureBuilding(const untyped::Object& data) {
+static Json::Value SourceInfoBuilding(const SourceInfo& srcInfo) {
 	Json::Value curr;
+	curr["fileName"] = srcInfo.GetFileName();
+	curr["line"] = srcInfo.GetLine();
+	curr["column"] = srcInfo.GetColumn();
+	return curr;
+}
 
-	curr["id"] = data["id"].TO_ID_T();
-	curr["name"] = data["name"].ToString();
-	curr["namespace"] = data["namespace"].ToString();
-
-	Json::Value srcInfo;
-	const untyped::Object& srcInfoObj = data["srcInfo"].ToObject();
-	srcInfo["fileName"] = srcInfoObj["fileName"].ToString();
-	srcInfo["line"] = (int)srcInfoObj["line"].ToNumber();
-	srcInfo["column"] = (int)srcInfoObj["column"].ToNumber();
-	curr["srcInfo"] = srcInfo;
-
-	curr["structureType"] = data["structureType"].ToString();
+static Json::Value IDsBuilding(const std::vector<ID_T>& ids) {
+	Json::Value curr;
+	Json::ArrayIndex index = 0;
+	for (auto id : ids)
+		curr[index++] = GetIDString(id);
+	return curr;
+}
 
-	if (data.In("templateParent"))
-		curr["templateParent"] = data["templateParent"].TO_ID_T();
+Json::Value GraphToJsonVisitor::StructureBuilding(const StructureData& data) {
+	Json::Value curr;
 
-	if (data.In("nestedParent"))
-		curr["nestedParent"] = data["nestedParent"].TO_ID_T();
+	curr["id"] = GetIDString(data.id);
+	curr["name"] = data.name;
+	curr["namespace"] = data.nameSpace;
+	curr["srcInfo"] = SourceInfoBuilding(data.srcInfo);
+	curr["structureType"] = data.structureType;
 
-	Json::Value bases;
-	data["bases"].ToObject().ForEach([&bases](const untyped::Value& key, const untyped::Value& value) {
-		bases[(int)key.ToNumber()] = value.ToString();
-		});
-	curr["bases"] = bases;
+	if (data.templateParent != NO_ID)
+		curr["templateParent"] = GetIDString(data.templateParent);
 
-	Json::Value friends;
-	data["friends"].ToObject().ForEach([&friends](const untyped::Value& key, const untyped::Value& value) {
-		friends[(int)key.ToNumber()] = value.ToString();
-		});
-	curr["friends"] = friends;
+	if (data.nestedParent != NO_ID)
+		curr["nestedParent"] = GetIDString(data.nestedParent);
 
-	Json::Value templArgs;
-	data["templateArguments"].ToObject().ForEach([&templArgs](const untyped::Value& key, const untyped::Value& value) {
-		templArgs[(int)key.ToNumber()] = value.ToString();
-		});
-	curr["templateArguments"] = templArgs;
+	curr["bases"] = IDsBuilding(data.bases);
+	curr["friends"] = IDsBuilding(data.friends);
+	curr["templateArguments"] = IDsBuilding(data.templateArguments);
 
 	Json::Value fields;
-	data["fields"].ToObject().ForEach([&fields, this](const untyped::Value& key, const untyped::Value& value) {
-		fields[key.TO_ID_T()] = DefinitionBuilding(value.ToObject());
-		});
+	for (const auto& field : data.fields)
+		fields[GetIDString(field.id)] = DefinitionBuilding(field);
 	curr["fields"] = fields;
 
 	Json::Value methods; 
-	data["methods"].ToObject().ForEach([&methods, this](const untyped::Value& key, const untyped::Value& value) {
-		methods[key.TO_ID_T()] = MethodBuilding(value.ToObject());
-		});
+	for (const auto& method : data.methods)
+		methods[GetIDString(method.id)] = MethodBuilding(method);
 	curr["methods"] = methods;
 
 	return curr;
 }
 
-Json::Value GraphToJsonVisitor::MethodBuilding(const untyped::Object& data) {
+Json::Value GraphToJsonVisitor::MethodBuilding(const MethodData& data) {
 	Json::Value curr;
-	curr["id"] = data["id"].TO_ID_T();
-	curr["name"] = data["name"].ToString();
-	curr["namespace"] = data["namespace"].ToString();
-
-	Json::Value srcInfo;
-	const untyped::Object& srcInfoObj = data["srcInfo"].ToObject();
-	srcInfo["fileName"] = srcInfoObj["fileName"].ToString();
-	srcInfo["line"] = (int)srcInfoObj["line"].ToNumber();
-	srcInfo["column"] = (int)srcInfoObj["column"].ToNumber();
-	curr["srcInfo"] = srcInfo;
-
-	curr["methodType"] = data["methodType"].ToString();
+	curr["id"] = GetIDString(data.id);
+	curr["name"] = data.name;
+	curr["namespace"] = data.nameSpace;
+	curr["srcInfo"] = SourceInfoBuilding(data.srcInfo);
+	curr["methodType"] = data.methodType;
 	
-	if (data.In("returnType"))
-		curr["returnType"] = data["returnType"].TO_ID_T();
+	if (data.returnType != NO_ID)
+		curr["returnType"] = GetIDString(data.returnType);
 
 	Json::Value args;
-	data["arguments"].ToObject().ForEach([&args, this](const untyped::Value& key, const untyped::Value& value) {
-		args[key.TO_ID_T()] = DefinitionBuilding(value.ToObject());
-		});
+	for (const auto& arg : data.arguments)
+		args[GetIDString(arg.id)] = DefinitionBuilding(arg);
 	curr["arguments"] = args;
 
 	Json::Value defs;
-	data["definitions"].ToObject().ForEach([&defs, this](const untyped::Value& key, const untyped::Value& value) {
-		defs[key.TO_ID_T()] = DefinitionBuilding(value.ToObject());
-		});
-	curr["definitions"] = args;
+	for (const auto& def : data.definitions)
+		defs[GetIDString(def.id)] = DefinitionBuilding(def);
+	curr["definitions"] = defs;
 
-	Json::Value templArgs;
-	data["templateArguments"].ToObject().ForEach([&templArgs](const untyped::Value& key, const untyped::Value& value) {
-		templArgs[(int)key.ToNumber()] = value.ToString();
-		});
-	curr["templateArguments"] = templArgs;
+	curr["templateArguments"] = IDsBuilding(data.templateArguments);
 
 	Json::Value memberExprs; 
-	int index = 0;
-	auto& memberExprsObj = data["memberExprs"].ToObject();
-	memberExprsObj.ForEach([&memberExprs, &index](const untyped::Value& key, const untyped::Value& value) {
+	Json::ArrayIndex index = 0;
+	for (const auto& memberExprData : data.memberExprs) {
 		Json::Value memberExpr;
-		auto& memberExprObj = value.ToObject(); 
-		memberExpr["expr"] = memberExprObj["expr"].ToString();
-
-		Json::Value srcInfo;
-		const untyped::Object& srcInfoObj = memberExprObj["srcInfo"].ToObject();
-		srcInfo["fileName"] = srcInfoObj["fileName"].ToString();
-		srcInfo["line"] = (int)srcInfoObj["line"].ToNumber();
-		srcInfo["column"] = (int)srcInfoObj["column"].ToNumber();
-		memberExpr["srcInfo"] = srcInfo;
+		memberExpr["expr"] = memberExprData.expr;
+		memberExpr["srcInfo"] = SourceInfoBuilding(memberExprData.srcInfo);
 
 		Json::Value members;
-		auto& membersObj = memberExprObj["members"].ToObject();
-		membersObj.ForEach([&members](const untyped::Value& key, const untyped::Value& value) {
+		Json::ArrayIndex index2 = 0;
+		for (const auto& memberData : memberExprData.members) {
 			Json::Value member;
-			auto& memberObj = value.ToObject();
-			member["name"] = memberObj["name"].ToString();
-			member["type"] = memberObj["type"].TO_ID_T();
-			member["memberType"] = memberObj["memberType"].ToString();
-
-			Json::Value locEnd;
-			const untyped::Object& locEndObj = memberObj["locEnd"].ToObject();
-			locEnd["fileName"] = locEndObj["fileName"].ToString();
-			locEnd["line"] = (int)locEndObj["line"].ToNumber();
-			locEnd["column"] = (int)locEndObj["column"].ToNumber();
-			member["locEnd"] = locEnd;
-
-			members[(int)key.ToNumber()] = member;
-
-			});
-		memberExpr["members"] = members;
+			member["name"] = memberData.name;
+			member["type"] = GetIDString(memberData.type);
+			member["memberType"] = memberData.memberType;
+			member["locEnd"] = SourceInfoBuilding(memberData.locEnd);
+			members[index2++] = member;
+		}
+		if (index2)												// no key if all the member types are undefined
+			memberExpr["members"] = members;
 
 		memberExprs[index++] = memberExpr;
-		});
-
+	}
 	curr["memberExprs"] = memberExprs;
 
 	return curr;
 }
 
-Json::Value GraphToJsonVisitor::DefinitionBuilding(const untyped::Object& data) {
+Json::Value GraphToJsonVisitor::DefinitionBuilding(const DefinitionData& data) {
 	Json::Value curr;
-	curr["id"] = data["id"].TO_ID_T();
-	curr["name"] = data["name"].ToString();
-	curr["namespace"] = data["namespace"].ToString();
-
-	Json::Value srcInfo;
-	const untyped::Object& srcInfoObj = data["srcInfo"].ToObject();
-	srcInfo["fileName"] = srcInfoObj["fileName"].ToString();
-	srcInfo["line"] = (int)srcInfoObj["line"].ToNumber();
-	srcInfo["column"] = (int)srcInfoObj["column"].ToNumber();
-	curr["srcInfo"] = srcInfo;
-
-	curr["type"] = data["type"].TO_ID_T();
+	curr["id"] = GetIDString(data.id);
+	curr["name"] = data.name;
+	curr["namespace"] = data.nameSpace;
+	curr["srcInfo"] = SourceInfoBuilding(data.srcInfo);
+	curr["type"] = GetIDString(data.type);
 	return curr;
 }
 
 
-void GraphToJsonVisitor::VisitNode(Node* node) {
-	untyped::Object data = node->GetData();
-	ID_T id = node->GetID();
-	json["nodes"][id] = StructureBuilding(data);
+void GraphToJsonVisitor::VisitNode(const CSRGraph& graph, CSRGraph::Index node) {
+	const auto& id = GetIDString(graph.GetID(node));
+	json["nodes"][id] = StructureBuilding(graph.GetData(node));
 
-	node->ForEachEdge([&id, this](Edge* edge) {
+	graph.ForEachEdge(node, [&graph, &id, this](CSRGraph::Index edge, CSRGraph::Index) {
 		Json::Value edgeJson; 
 		edgeJson["from"] = id; 
 		json["edges"][edgesIndex] = edgeJson;
-		VisitEdge(edge); 
+		VisitEdge(graph, edge); 
 		});
 }
 
-void GraphToJsonVisitor::VisitEdge(Edge* edge) {
+void GraphToJsonVisitor::VisitEdge(const CSRGraph& graph, CSRGraph::Index edge) {
 	Json::Value& edgeJson = json["edges"][edgesIndex];
 
-	edgeJson["to"] = edge->GetTo()->GetID();
+	edgeJson["to"] = GetIDString(graph.GetID(graph.GetTo(edge)));
 
 	Json::Value dependencies;
-	for (auto it : edge->GetDependencies()) {
-		auto depType = it.first;
-		auto cardinality = it.second; 
-		dependencies[depType] = cardinality;
-	}
+	graph.ForEachDependency(edge, [&dependencies](Edge::DependencyType depType, Edge::Cardinality cardinality) {
+		dependencies[GetDependencyTypeName(depType)] = cardinality;
+		});
 	edgeJson["dependencies"] = dependencies;
 
 	edgesIndex++;
 }
 
+void GraphToJsonVisitor::Visit(const CSRGraph& graph) {
+	for (CSRGraph::Index node = 0; node < graph.NodesSize(); ++node)
+		VisitNode(graph, node);
+}
+
 std::string GraphToJsonVisitor::GetJsonAsString() const {
 	return json.toStyledString();
 }
@@ -193,14 +150,14 @@ Json::Value GraphToJsonVisitor::GetJson() const {
 	return json;
 }
 
-Json::Value graphToJson::GetJson(const Graph& graph) {
+Json::Value graphToJson::GetJson(const CSRGraph& graph) {
 	GraphToJsonVisitor visitor;
-	graph.Accept(&visitor);
+	visitor.Visit(graph);
 	return visitor.GetJson();
 }
 
-std::string graphToJson::GetJsonString(const Graph& graph) {
+std::string graphToJson::GetJsonString(const CSRGraph& graph) {
 	GraphToJsonVisitor visitor;
-	graph.Accept(&visitor);
+	visitor.Visit(graph);
 	return visitor.GetJsonAsString();
 }
@@ -1,30 +1,31 @@
 #pragma once
-#include "GraphVisitor.h"
+#include "CSRGraph.h"
 #include <json/json.h>
 
 using namespace graph;
 
 namespace graphToJson {
 
-	class GraphToJsonVisitor : public GraphVisitor {
+	class GraphToJsonVisitor {
 		Json::Value json; 
 		int edgesIndex = 0;
 
-		Json::Value StructureBuilding(const untyped::Object& data);
-		Json::Value MethodBuilding(const untyped::Object& data);
-		Json::Value DefinitionBuilding(const untyped::Object& data);
+		Json::Value StructureBuilding(const StructureData& data);
+		Json::Value MethodBuilding(const MethodData& data);
+		Json::Value DefinitionBuilding(const DefinitionData& data);
 	public:
 		GraphToJsonVisitor() {
 			json["nodes"] = Json::Value(); 
 			json["edges"] = Json::Value(); 
 		}
 
-		virtual void VisitNode(Node* node);
-		virtual void VisitEdge(Edge* edge);
+		void VisitNode(const CSRGraph& graph, CSRGraph::Index node);
+		void VisitEdge(const CSRGraph& graph, CSRGraph::Index edge);
+		void Visit(const CSRGraph& graph);
 		std::string GetJsonAsString() const;
 		Json::Value GetJson() const;
 	};
 
-	std::string GetJsonString(const Graph& graph);
-	Json::Value GetJson(const Graph& graph);
+	std::string GetJsonString(const CSRGraph& graph);
+	Json::Value GetJson(const CSRGraph& graph);
 }
@@ -6,7 +6,14 @@
 #include "DependenciesMining.h"
 #include "GraphGeneration.h"
 #include "GraphToJson.h"
+#include "STToJson.h"
+#include "STBinaryWriter.h"
+#include "STSerialization.h"
+#include "Arena.h"
+#include "Tracing.h"
+#include "Arguments.h"
 #include "json/writer.h"
+#include "llvm/Support/FileSystem.h"
 
 static void PrintMainArgInfo(void) {
 	std::cout << "MAIN ARGUMENTS:\n\n";
@@ -15,29 +22,55 @@ static void PrintMainArgInfo(void) {
 	std::cout << "argv[3]: (file path) path/to/ignoredFilePaths\n";
 	std::cout << "argv[4]: (file path) path/to/ignoredNamespaces\n";
 	std::cout << "argv[5]: (file path) path/to/ST-output\n";
+	std::cout << "\nOPTIONAL ARGUMENTS (after argv[5]):\n\n";
+	std::cout << "--jobs N: mine the translation units on N worker threads (0: one per hardware thread, default: 1), the longest first (by their durations on the previous runs, kept next to the ST in PATH/to/ST-output.timings); every TU mines the headers it includes (only a serial run without --cache-dir skips the declarations of the headers mined by a previous TU)\n";
+	std::cout << "--cache-dir DIR: reuse what unchanged translation units contributed on previous runs (cache kept in DIR); every TU mines the headers it includes\n";
+	std::cout << "--skip-ignored-bodies: do not parse the function bodies of the ignored files, strip the code generation flags of the compile commands\n";
+	std::cout << "--depth=full|signatures|structure: mine everything (default), everything but the function bodies (not parsed) or the structures and their fields only\n";
+	std::cout << "--progressive: first write a skeleton ST (structures, fields, method signatures, no function body parsed), then replace it with the full ST\n";
+	std::cout << "--binary-st PATH: also write the ST in binary form (memory mapped by STBinaryReader) to PATH\n";
+	std::cout << "--arena-stats: print the objects and bytes allocated per kind (symbols, graph nodes/edges) at the end\n";
+	std::cout << "--naming-stats: print the hit rate of the per TU structure and method names cache at the end\n";
+	std::cout << "--shard i/N: mine only shard i (0 ... N - 1) of the translation units, write a partial ST (binary, not JSON) to PATH/to/ST-output instead of the ST (merged by st-merge, which writes the ST and its binary form), not with --binary-st, no skeleton with --progressive\n";
+	std::cout << "--trace PATH: time the phases, the translation units and the mining callbacks, write them to PATH (Chrome trace event format) and print a summary\n";
 }
 
-static void SetDepedenciesToST(const Json::Value& graph, Json::Value& ST) {
-	const Json::Value& all_dependencies = graph["edges"];
-	auto& st_dependencies = ST["dependencies"];
-	for (const auto& dependencies : all_dependencies) {
-		
-		Json::Value dependency_pack;
-		dependency_pack["types"] = dependencies["dependencies"];
-		dependency_pack["from"] = dependencies["from"];
-		dependency_pack["to"] = dependencies["to"];
+/*
+	Writes the ST (and its binary form) to temporary files and renames them over the outputs,
+	so readers never see a partially written ST (e.g. the skeleton being replaced by the full ST).
+	pass: prefix of the traced phase names
+*/
+static void WriteSTFiles(const std::string& jsonSTPath, const std::string& binarySTPath, const std::vector<std::string>& srcs, const std::vector<std::string>& headers, const std::string& pass = "") {
+	tracing::Scope generationPhase(tracing::Category::Phase, pass + "GenetareDependenciesGraph");
+	auto dependenciesGraph = graphGeneration::GenetareDependenciesGraph(dependenciesMining::structuresTable);
+	generationPhase.End();
+	tracing::Scope csrPhase(tracing::Category::Phase, pass + "CSRGraph");
+	graph::CSRGraph graph(dependenciesGraph);
+	csrPhase.End();
 
-		st_dependencies.append(dependency_pack);
-	}
+	tracing::Scope writePhase(tracing::Category::Phase, pass + "WriteST");
+	std::string jsonSTTempPath = jsonSTPath + ".tmp";
+	std::ofstream jsonSTFile(jsonSTTempPath);
+	stToJson::WriteST(jsonSTFile, dependenciesMining::structuresTable, graph, srcs, headers);
+	jsonSTFile.close();
+	if (!jsonSTFile || llvm::sys::fs::rename(jsonSTTempPath, jsonSTPath))
+		std::cout << "Could not write the ST to " << jsonSTPath << "\n";
+	writePhase.End();
+	if (binarySTPath == "")
+		return;
+	tracing::Scope writeBinaryPhase(tracing::Category::Phase, pass + "WriteSTBinary");
+	std::string binarySTTempPath = binarySTPath + ".tmp";
+	if (!stBinary::WriteSTBinary(binarySTTempPath, dependenciesMining::structuresTable, graph, srcs, headers) || llvm::sys::fs::rename(binarySTTempPath, binarySTPath))
+		std::cout << "Could not write the binary ST to " << binarySTPath << "\n";
 }
 
-static void SetCodeFilesToST(Json::Value& ST, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
-	for (const auto& path : srcs) {
-		ST["sources"].append(path);
-	}
-	for (const auto& path : headers) {
-		ST["headers"].append(path);
-	}
+// The output of a shard, replaced as the ST
+static bool WritePartialSTFile(const std::string& path, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	std::string tempPath = path + ".tmp";
+	std::ofstream file(tempPath, std::ios::binary);
+	dependenciesMining::WritePartialST(file, dependenciesMining::structuresTable, srcs, headers);
+	file.close();
+	return file && !llvm::sys::fs::rename(tempPath, path);
 }
 
 int main(int argc, const char** argv) {
@@ -74,6 +107,62 @@ int main(int argc, const char** argv) {
 	/*std::string jsonPath = (argc >= 6) ? argv[5] : fullPath.substr(0, found + 1) + "../../GraphVisualizer/Graph/graph.json";
 	std::string jsonSTPath = (argc >= 7) ? argv[6] : fullPath.substr(0, found + 1) + "../../ST0.json";*/
 	std::string jsonSTPath = argv[5];
+
+	dependenciesMining::MiningOptions options;
+	options.timingsPath = jsonSTPath + ".timings";
+	bool arenaStats = false;
+	bool namingStats = false;
+	bool progressive = false;
+	std::string tracePath;
+	std::string binarySTPath;
+	for (int i = 6; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--jobs" && i + 1 < argc && arguments::ParseUnsigned(argv[i + 1], options.jobs)) {
+			++i;
+		}
+		else if (arg == "--cache-dir" && i + 1 < argc) {
+			options.cacheDir = argv[++i];
+		}
+		else if (arg == "--skip-ignored-bodies") {
+			options.skipIgnoredBodies = true;
+		}
+		else if (arg == "--depth=full") {
+			options.depth = dependenciesMining::MiningDepth::Full;
+		}
+		else if (arg == "--depth=signatures") {
+			options.depth = dependenciesMining::MiningDepth::Signatures;
+		}
+		else if (arg == "--depth=structure") {
+			options.depth = dependenciesMining::MiningDepth::Structure;
+		}
+		else if (arg == "--progressive") {
+			progressive = true;
+		}
+		else if (arg == "--binary-st" && i + 1 < argc) {
+			binarySTPath = argv[++i];
+		}
+		else if (arg == "--arena-stats") {
+			arenaStats = true;
+		}
+		else if (arg == "--naming-stats") {
+			namingStats = true;
+		}
+		else if (arg == "--shard" && i + 1 < argc && arguments::ParseShard(argv[i + 1], options.shardIndex, options.shardCount)) {
+			++i;
+		}
+		else if (arg == "--trace" && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else {
+			PrintMainArgInfo();
+			return 1;
+		}
+	}
+	if (options.shardCount > 1 && binarySTPath != "") {
+		std::cout << "--binary-st cannot be used with --shard (st-merge --binary-st writes the binary ST of the shards)\n\n";
+		PrintMainArgInfo();
+		return 1;
+	}
 	
 	/*std::vector<std::string> srcs;
 	srcs.push_back(path + "\\classes_simple.cpp");			
@@ -92,22 +181,39 @@ int main(int argc, const char** argv) {
 	srcs.push_back(path + "\\include.h");						
 	srcs.push_back(path + "\\include2.h");*/
 				
-	std::cout << "\n-------------------------------------------------------------------------------------\n\n";
-	int result = dependenciesMining::CreateClangTool(cmpDBPath, srcs, headers, ignoredFilePaths, ignoredNamespaces);
-	
+	if (tracePath != "")
+		tracing::Enable();
 
-
-	
-	Json::Value json_ST;
-	structuresTable.AddJsonSymbolTable(json_ST["structures"]);
-	std::ofstream jsonSTFile(jsonSTPath);
+	std::cout << "\n-------------------------------------------------------------------------------------\n\n";
+	// Skeleton first: the signatures pass, its ST is replaced by the one of the full pass
+	if (progressive && options.depth == dependenciesMining::MiningDepth::Full && options.shardCount == 1) {
+		auto skeletonOptions = options;
+		skeletonOptions.depth = dependenciesMining::MiningDepth::Signatures;
+		skeletonOptions.timingsPath = jsonSTPath + ".skeleton.timings";		// not the durations of the full pass
+		std::vector<std::string> skeletonSrcs = srcs;
+		std::vector<std::string> skeletonHeaders;
+		tracing::Scope skeletonPhase(tracing::Category::Phase, "Skeleton: CreateClangTool");
+		dependenciesMining::CreateClangTool(cmpDBPath, skeletonSrcs, skeletonHeaders, ignoredFilePaths, ignoredNamespaces, skeletonOptions);
+		skeletonPhase.End();
+		WriteSTFiles(jsonSTPath, binarySTPath, skeletonSrcs, skeletonHeaders, "Skeleton: ");
+		std::cout << "\nSKELETON WRITTEN\n\n";
+		dependenciesMining::structuresTable.Clear();
+		arena::Release();
+	}
+	tracing::Scope miningPhase(tracing::Category::Phase, "CreateClangTool");
+	int result = dependenciesMining::CreateClangTool(cmpDBPath, srcs, headers, ignoredFilePaths, ignoredNamespaces, options);
+	miningPhase.End();
 	
-	graph::Graph graph = graphGeneration::GenetareDependenciesGraph(dependenciesMining::structuresTable);
-	auto g = graphToJson::GetJson(graph);
-	SetDepedenciesToST(g, json_ST);
-	SetCodeFilesToST(json_ST, srcs, headers);
-	jsonSTFile << json_ST;
-	jsonSTFile.close();
+	if (options.shardCount > 1) {
+		tracing::Scope writePhase(tracing::Category::Phase, "WritePartialST");
+		if (WritePartialSTFile(jsonSTPath, srcs, headers))
+			std::cout << "\nPARTIAL ST WRITTEN (shard " << options.shardIndex << "/" << options.shardCount << ")\n";
+		else
+			std::cout << "Could not write the partial ST to " << jsonSTPath << "\n";
+	}
+	else {
+		WriteSTFiles(jsonSTPath, binarySTPath, srcs, headers);
+	}
 	//std::cout << json_ST << std::endl;
 	// --------- Phiv ends here -------------------
 	/*std::string json_graph_str = graphToJson::GetJsonString(graph);
@@ -117,5 +223,20 @@ int main(int argc, const char** argv) {
 	jsonFile.open(jsonPath);
 	jsonFile << json_graph_str;
  	jsonFile.close();*/
+	if (arenaStats)
+		arena::PrintStats();
+	if (namingStats) {
+		auto stats = dependenciesMining::GetNamingStats();
+		auto lookups = stats.hits + stats.misses;
+		std::cout << "Names cache: " << stats.hits << "/" << lookups << " lookups hit";
+		if (lookups)
+			std::cout << " (" << 100 * stats.hits / lookups << "%)";
+		std::cout << "\n";
+	}
+	if (tracePath != "") {
+		tracing::PrintSummary();
+		if (!tracing::WriteChromeTrace(tracePath))
+			std::cout << "Could not write the trace to " << tracePath << "\n";
+	}
 	std::cout << "\nCOMPILATION FINISHED\n";
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+
+/*
+	Binary ST (the contents of ST.json in a form that is used in place, without parsing):
+
+		Header
+		string offsets			uint64_t[stringCount + 1], string i is data[offsets[i], offsets[i + 1])
+		string data
+		structures				StructureRecord[structureCount], sorted by id (binary search by id)
+		methods					MethodRecord[methodCount], the methods of a structure are contiguous
+		definitions				DefinitionRecord[definitionCount], fields, method args and method definitions
+		structure refs			uint32_t[structureRefCount], bases, friends, contains and template args lists
+		dependency rows			uint32_t[structureCount + 1], CSR: the edges from structure i are edges[rows[i], rows[i + 1])
+		edges					EdgeRecord[edgeCount]
+		edge types				EdgeTypeRecord[edgeTypeCount]
+		code files				uint32_t[sourceCount + headerCount], string indices
+
+	Every section starts 8 byte aligned, all the records are made of 32 bit fields (native byte order, the
+	files are not portable across endianness). Strings are referred to by index to the string table,
+	structures by index to the structure records (ST_BINARY_NONE if there is no structure).
+	Enumerations (structure type, method type, access) are stored as strings, as in ST.json.
+*/
+
+#define ST_BINARY_MAGIC "CSDB"
+#define ST_BINARY_VERSION 1
+#define ST_BINARY_NONE 0xFFFFFFFFu
+
+namespace stBinary {
+
+	struct SectionRecord {
+		uint64_t offset;
+		uint64_t count;
+	};
+
+	struct Header {
+		char magic[4];
+		uint32_t version;
+		SectionRecord stringOffsets;
+		SectionRecord stringData;
+		SectionRecord structures;
+		SectionRecord methods;
+		SectionRecord definitions;
+		SectionRecord structureRefs;
+		SectionRecord dependencyRows;
+		SectionRecord edges;
+		SectionRecord edgeTypes;
+		SectionRecord sources;
+		SectionRecord headers;
+	};
+
+	// [first, first + count) of a section
+	struct RangeRecord {
+		uint32_t first;
+		uint32_t count;
+	};
+
+	struct SourceInfoRecord {
+		uint32_t file;
+		int32_t line;
+		int32_t column;
+	};
+
+	struct DefinitionRecord {
+		uint32_t id;
+		uint32_t name;
+		uint32_t nameSpace;
+		SourceInfoRecord srcInfo;
+		uint32_t access;
+		uint32_t type;							// structure
+		uint32_t fullType;
+	};
+
+	struct MethodRecord {
+		uint32_t id;
+		uint32_t name;
+		uint32_t nameSpace;
+		SourceInfoRecord srcInfo;
+		uint32_t access;
+		uint32_t methodType;
+		uint32_t returnType;					// structure
+		RangeRecord arguments;					// definitions
+		RangeRecord definitions;				// definitions
+		RangeRecord templateArguments;			// structure refs
+		int32_t literals;
+		int32_t statements;
+		int32_t branches;
+		int32_t loops;
+		int32_t maxScopeDepth;
+		int32_t lineCount;
+		uint32_t isVirtual;
+	};
+
+	struct StructureRecord {
+		uint32_t id;
+		uint32_t name;
+		uint32_t nameSpace;
+		SourceInfoRecord srcInfo;
+		uint32_t structureType;
+		uint32_t templateParent;				// structure
+		uint32_t nestedParent;					// structure
+		RangeRecord methods;					// methods
+		RangeRecord fields;						// definitions
+		RangeRecord bases;						// structure refs
+		RangeRecord friends;					// structure refs
+		RangeRecord contains;					// structure refs
+		RangeRecord templateArguments;			// structure refs
+	};
+
+	struct EdgeRecord {
+		uint32_t to;							// structure
+		RangeRecord types;						// edge types
+	};
+
+	struct EdgeTypeRecord {
+		uint32_t type;
+		uint32_t cardinality;
+	};
+
+	static_assert(sizeof(Header) == 8 + 11 * sizeof(SectionRecord), "Header must not be padded");
+	static_assert(sizeof(DefinitionRecord) == 9 * 4, "DefinitionRecord must not be padded");
+	static_assert(sizeof(MethodRecord) == 22 * 4, "MethodRecord must not be padded");
+	static_assert(sizeof(StructureRecord) == 21 * 4, "StructureRecord must not be padded");
+}
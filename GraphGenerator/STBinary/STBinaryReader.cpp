@@ -0,0 +1,179 @@
+#include "STBinaryReader.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace stBinary;
+
+STFile::~STFile() {
+	Close();
+}
+
+bool STFile::Open(const std::string& path) {
+	Close();
+#ifdef _WIN32
+	file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		file = nullptr;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(Header)) {
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping)
+		data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(Header)) {
+		size = (size_t)st.st_size;
+		void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED)
+			data = (const char*)mapped;
+	}
+	close(fd);										// the mapping keeps the file
+#endif
+	if (!data || !IsValid()) {
+		Close();
+		return false;
+	}
+	header = (const Header*)data;
+	return true;
+}
+
+void STFile::Close() {
+#ifdef _WIN32
+	if (data)
+		UnmapViewOfFile(data);
+	if (mapping)
+		CloseHandle(mapping);
+	if (file)
+		CloseHandle(file);
+	mapping = file = nullptr;
+#else
+	if (data)
+		munmap((void*)data, size);
+#endif
+	data = nullptr;
+	size = 0;
+	header = nullptr;
+}
+
+// The sections must be in the file, the records are trusted after that
+bool STFile::IsValid() const {
+	auto* h = (const Header*)data;
+	if (std::memcmp(h->magic, ST_BINARY_MAGIC, 4) || h->version != ST_BINARY_VERSION)
+		return false;
+	auto inFile = [this](const SectionRecord& section, size_t recordSize) {
+		return section.offset % 8 == 0 && section.offset <= size && section.count <= (size - section.offset) / recordSize;
+	};
+	if (!inFile(h->stringOffsets, sizeof(uint64_t)) || !inFile(h->stringData, 1) || !inFile(h->structures, sizeof(StructureRecord))
+		|| !inFile(h->methods, sizeof(MethodRecord)) || !inFile(h->definitions, sizeof(DefinitionRecord)) || !inFile(h->structureRefs, sizeof(uint32_t))
+		|| !inFile(h->dependencyRows, sizeof(uint32_t)) || !inFile(h->edges, sizeof(EdgeRecord)) || !inFile(h->edgeTypes, sizeof(EdgeTypeRecord))
+		|| !inFile(h->sources, sizeof(uint32_t)) || !inFile(h->headers, sizeof(uint32_t)))
+		return false;
+	if (h->stringOffsets.count == 0 || h->dependencyRows.count != h->structures.count + 1)
+		return false;
+	auto* stringOffsets = (const uint64_t*)(data + h->stringOffsets.offset);
+	return stringOffsets[h->stringOffsets.count - 1] <= h->stringData.count;
+}
+
+// ----------------------------------------------------------------------------------------
+
+std::string_view STFile::GetString(uint32_t index) const {
+	if (index >= header->stringOffsets.count - 1)
+		return std::string_view();
+	auto* offsets = (const uint64_t*)(data + header->stringOffsets.offset);
+	return std::string_view(data + header->stringData.offset + offsets[index], (size_t)(offsets[index + 1] - offsets[index]));
+}
+
+Range<StructureRecord> STFile::GetStructures() const {
+	return GetSection<StructureRecord>(header->structures);
+}
+
+const StructureRecord* STFile::GetStructure(uint32_t index) const {
+	if (index >= header->structures.count)
+		return nullptr;
+	return &GetStructures()[index];
+}
+
+const StructureRecord* STFile::FindStructure(std::string_view id) const {
+	auto structures = GetStructures();
+	auto it = std::lower_bound(structures.begin(), structures.end(), id, [this](const StructureRecord& structure, std::string_view id) {
+		return GetString(structure.id) < id;
+		});
+	if (it == structures.end() || GetString(it->id) != id)
+		return nullptr;
+	return it;
+}
+
+uint32_t STFile::GetIndex(const StructureRecord& structure) const {
+	return (uint32_t)(&structure - GetStructures().begin());
+}
+
+Range<MethodRecord> STFile::GetMethods(const StructureRecord& structure) const {
+	return GetRange<MethodRecord>(header->methods, structure.methods);
+}
+
+Range<DefinitionRecord> STFile::GetFields(const StructureRecord& structure) const {
+	return GetRange<DefinitionRecord>(header->definitions, structure.fields);
+}
+
+Range<uint32_t> STFile::GetBases(const StructureRecord& structure) const {
+	return GetRange<uint32_t>(header->structureRefs, structure.bases);
+}
+
+Range<uint32_t> STFile::GetFriends(const StructureRecord& structure) const {
+	return GetRange<uint32_t>(header->structureRefs, structure.friends);
+}
+
+Range<uint32_t> STFile::GetContains(const StructureRecord& structure) const {
+	return GetRange<uint32_t>(header->structureRefs, structure.contains);
+}
+
+Range<uint32_t> STFile::GetTemplateArguments(const StructureRecord& structure) const {
+	return GetRange<uint32_t>(header->structureRefs, structure.templateArguments);
+}
+
+Range<DefinitionRecord> STFile::GetArguments(const MethodRecord& method) const {
+	return GetRange<DefinitionRecord>(header->definitions, method.arguments);
+}
+
+Range<DefinitionRecord> STFile::GetDefinitions(const MethodRecord& method) const {
+	return GetRange<DefinitionRecord>(header->definitions, method.definitions);
+}
+
+Range<uint32_t> STFile::GetTemplateArguments(const MethodRecord& method) const {
+	return GetRange<uint32_t>(header->structureRefs, method.templateArguments);
+}
+
+Range<EdgeRecord> STFile::GetDependencies(const StructureRecord& structure) const {
+	auto rows = GetSection<uint32_t>(header->dependencyRows);
+	auto index = GetIndex(structure);
+	return GetRange<EdgeRecord>(header->edges, { rows[index], rows[index + 1] - rows[index] });
+}
+
+Range<EdgeTypeRecord> STFile::GetTypes(const EdgeRecord& edge) const {
+	return GetRange<EdgeTypeRecord>(header->edgeTypes, edge.types);
+}
+
+Range<uint32_t> STFile::GetSources() const {
+	return GetSection<uint32_t>(header->sources);
+}
+
+Range<uint32_t> STFile::GetHeaders() const {
+	return GetSection<uint32_t>(header->headers);
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include "STBinaryFormat.h"
+
+/*
+	Reader of the binary ST: the file is memory mapped and its records are used in place, opening
+	costs the header checks only. Structures are found by id with a binary search.
+	Stand-alone (no SymbolTable, Clang or json), so that tools that consume the ST can link it alone.
+*/
+
+namespace stBinary {
+
+	template<typename T> class Range {
+	private:
+		const T* first = nullptr;
+		const T* last = nullptr;
+	public:
+		Range() = default;
+		Range(const T* first, size_t count) : first(first), last(first + count) {};
+		const T* begin() const { return first; }
+		const T* end() const { return last; }
+		size_t size() const { return last - first; }
+		bool empty() const { return first == last; }
+		const T& operator[](size_t i) const { return first[i]; }
+	};
+
+	class STFile {
+	private:
+		const char* data = nullptr;
+		size_t size = 0;
+		const Header* header = nullptr;
+#ifdef _WIN32
+		void* file = nullptr;
+		void* mapping = nullptr;
+#endif
+
+		template<typename T> Range<T> GetSection(const SectionRecord& section) const {
+			return Range<T>((const T*)(data + section.offset), (size_t)section.count);
+		}
+		template<typename T> Range<T> GetRange(const SectionRecord& section, const RangeRecord& range) const {
+			return Range<T>((const T*)(data + section.offset) + range.first, range.count);
+		}
+		bool IsValid() const;
+
+	public:
+		STFile() = default;
+		STFile(const STFile&) = delete;
+		STFile& operator=(const STFile&) = delete;
+		~STFile();
+
+		// Returns false if the file cannot be mapped or it is not a (compatible) binary ST
+		bool Open(const std::string& path);
+		void Close();
+
+		std::string_view GetString(uint32_t index) const;
+
+		Range<StructureRecord> GetStructures() const;
+		const StructureRecord* GetStructure(uint32_t index) const;			// nullptr for ST_BINARY_NONE
+		const StructureRecord* FindStructure(std::string_view id) const;
+		uint32_t GetIndex(const StructureRecord& structure) const;
+
+		Range<MethodRecord> GetMethods(const StructureRecord& structure) const;
+		Range<DefinitionRecord> GetFields(const StructureRecord& structure) const;
+		Range<uint32_t> GetBases(const StructureRecord& structure) const;
+		Range<uint32_t> GetFriends(const StructureRecord& structure) const;
+		Range<uint32_t> GetContains(const StructureRecord& structure) const;
+		Range<uint32_t> GetTemplateArguments(const StructureRecord& structure) const;
+
+		Range<DefinitionRecord> GetArguments(const MethodRecord& method) const;
+		Range<DefinitionRecord> GetDefinitions(const MethodRecord& method) const;
+		Range<uint32_t> GetTemplateArguments(const MethodRecord& method) const;
+
+		// The dependencies from structure, one edge per dependent structure
+		Range<EdgeRecord> GetDependencies(const StructureRecord& structure) const;
+		Range<EdgeTypeRecord> GetTypes(const EdgeRecord& edge) const;
+
+		Range<uint32_t> GetSources() const;
+		Range<uint32_t> GetHeaders() const;
+	};
+}
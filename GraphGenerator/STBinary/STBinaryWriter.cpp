@@ -0,0 +1,274 @@
+#include "STBinaryWriter.h"
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+using namespace stBinary;
+using namespace dependenciesMining;
+using namespace graph;
+
+namespace {
+
+	class STBinaryWriter {
+	private:
+		std::unordered_map<std::string, uint32_t> stringIndex;
+		std::vector<uint64_t> stringOffsets = { 0 };
+		std::string stringData;
+
+		std::vector<const Structure*> structuresOrder;
+		std::unordered_map<const Symbol*, uint32_t> structureIndex;
+		std::unordered_map<ID_T, uint32_t> structureIndexByID;
+
+		std::vector<StructureRecord> structures;
+		std::vector<MethodRecord> methods;
+		std::vector<DefinitionRecord> definitions;
+		std::vector<uint32_t> structureRefs;
+		std::vector<std::vector<EdgeRecord>> edgesFrom;		// per structure, flattened to CSR when written
+		std::vector<EdgeTypeRecord> edgeTypes;
+		std::vector<uint32_t> codeFiles;						// sources then headers
+		uint32_t headersCount = 0;
+
+		uint32_t String(const std::string& str);
+		uint32_t StructureRef(const Symbol* structure) const;
+		SourceInfoRecord SourceInfoRef(const Symbol* symbol);
+		static std::vector<const Symbol*> Sorted(const SymbolTable& st, bool withSourceOnly);
+
+		RangeRecord AddStructureRefs(const SymbolTable& st);
+		RangeRecord AddDefinitions(const SymbolTable& st);
+		RangeRecord AddMethods(const SymbolTable& st);
+		void AddStructure(const Structure* structure);
+		void AddDependencies(const CSRGraph& graph);
+
+	public:
+		void Build(const SymbolTable& st, const CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers);
+		bool Write(const std::string& path) const;
+	};
+}
+
+// ----------------------------------------------------------------------------------------
+
+uint32_t STBinaryWriter::String(const std::string& str) {
+	auto it = stringIndex.find(str);
+	if (it != stringIndex.end())
+		return it->second;
+	uint32_t index = (uint32_t)stringIndex.size();
+	stringIndex.emplace(str, index);
+	stringData += str;
+	stringOffsets.push_back(stringData.size());
+	return index;
+}
+
+uint32_t STBinaryWriter::StructureRef(const Symbol* structure) const {
+	if (!structure)
+		return ST_BINARY_NONE;
+	auto it = structureIndex.find(structure);
+	return it != structureIndex.end() ? it->second : ST_BINARY_NONE;
+}
+
+SourceInfoRecord STBinaryWriter::SourceInfoRef(const Symbol* symbol) {
+	const auto& srcInfo = symbol->GetSourceInfo();
+	return { String(srcInfo.GetFileName()), srcInfo.GetLine(), srcInfo.GetColumn() };
+}
+
+// By id, so the records of a run do not depend on the hashing of the tables
+std::vector<const Symbol*> STBinaryWriter::Sorted(const SymbolTable& st, bool withSourceOnly) {
+	std::vector<const Symbol*> symbols;
+	for (const auto& it : st) {
+		if (withSourceOnly && it.second->GetSourceInfo().GetFileName() == "")
+			continue;
+		symbols.push_back(it.second);
+	}
+	std::sort(symbols.begin(), symbols.end(), [](const Symbol* a, const Symbol* b) {
+		return GetIDString(a->GetID()) < GetIDString(b->GetID());
+		});
+	return symbols;
+}
+
+RangeRecord STBinaryWriter::AddStructureRefs(const SymbolTable& st) {
+	RangeRecord range = { (uint32_t)structureRefs.size(), 0 };
+	for (const auto* symbol : Sorted(st, false)) {
+		auto index = StructureRef(symbol);
+		if (index == ST_BINARY_NONE)
+			continue;
+		structureRefs.push_back(index);
+		++range.count;
+	}
+	return range;
+}
+
+RangeRecord STBinaryWriter::AddDefinitions(const SymbolTable& st) {
+	RangeRecord range = { (uint32_t)definitions.size(), 0 };
+	for (const auto* symbol : Sorted(st, true)) {
+		auto* definition = (const Definition*)symbol;
+		DefinitionRecord record;
+		record.id = String(GetIDString(definition->GetID()));
+		record.name = String(definition->GetName());
+		record.nameSpace = String(definition->GetNamespace());
+		record.srcInfo = SourceInfoRef(definition);
+		record.access = String(definition->GetAccessTypeStr());
+		record.type = StructureRef(definition->GetType());
+		record.fullType = String(definition->GetFullType());
+		definitions.push_back(record);
+		++range.count;
+	}
+	return range;
+}
+
+RangeRecord STBinaryWriter::AddMethods(const SymbolTable& st) {
+	auto sorted = Sorted(st, true);
+	RangeRecord range = { (uint32_t)methods.size(), (uint32_t)sorted.size() };
+	methods.resize(methods.size() + sorted.size());
+	// the records of the methods first: the args and definitions of every method are contiguous
+	for (uint32_t i = 0; i < sorted.size(); ++i) {
+		auto* method = (const Method*)sorted[i];
+		MethodRecord& record = methods[range.first + i];
+		record.id = String(GetIDString(method->GetID()));
+		record.name = String(method->GetName());
+		record.nameSpace = String(method->GetNamespace());
+		record.srcInfo = SourceInfoRef(method);
+		record.access = String(method->GetAccessTypeStr());
+		record.methodType = String(method->GetMethodTypeAsString());
+		record.returnType = StructureRef(method->GetReturnType());
+		record.templateArguments = AddStructureRefs(method->GetTemplateArguments());
+		record.literals = method->GetLiterals();
+		record.statements = method->GetStatements();
+		record.branches = method->GetBranches();
+		record.loops = method->GetLoops();
+		record.maxScopeDepth = method->GetMaxScopeDepth();
+		record.lineCount = method->GetLineCount();
+		record.isVirtual = method->IsVirtual();
+	}
+	for (uint32_t i = 0; i < sorted.size(); ++i) {
+		auto* method = (const Method*)sorted[i];
+		auto arguments = AddDefinitions(method->GetArguments());
+		auto defs = AddDefinitions(method->GetDefinitions());
+		methods[range.first + i].arguments = arguments;
+		methods[range.first + i].definitions = defs;
+	}
+	return range;
+}
+
+void STBinaryWriter::AddStructure(const Structure* structure) {
+	StructureRecord record;
+	record.id = String(GetIDString(structure->GetID()));
+	record.name = String(structure->GetName());
+	record.nameSpace = String(structure->GetNamespace());
+	record.srcInfo = SourceInfoRef(structure);
+	record.structureType = String(structure->GetStructureTypeAsString());
+	record.templateParent = StructureRef(structure->GetTemplateParent());
+	record.nestedParent = StructureRef(structure->GetNestedParent());
+	record.methods = AddMethods(structure->GetMethods());
+	record.fields = AddDefinitions(structure->GetFields());
+	record.bases = AddStructureRefs(structure->GetBases());
+	record.friends = AddStructureRefs(structure->GetFriends());
+	record.contains = AddStructureRefs(structure->GetContains());
+	record.templateArguments = AddStructureRefs(structure->GetTemplateArguments());
+	structures.push_back(record);
+}
+
+void STBinaryWriter::AddDependencies(const CSRGraph& graph) {
+	edgesFrom.resize(structures.size());
+	for (CSRGraph::Index node = 0; node < graph.NodesSize(); ++node) {
+		auto from = structureIndexByID.find(graph.GetID(node));
+		if (from == structureIndexByID.end())
+			continue;
+		graph.ForEachEdge(node, [&](CSRGraph::Index edge, CSRGraph::Index toNode) {
+			auto to = structureIndexByID.find(graph.GetID(toNode));
+			if (to == structureIndexByID.end())
+				return;
+			EdgeRecord record = { to->second, { (uint32_t)edgeTypes.size(), 0 } };
+			graph.ForEachDependency(edge, [&](Edge::DependencyType depType, Edge::Cardinality card) {
+				edgeTypes.push_back({ String(GetDependencyTypeName(depType)), card });
+				++record.types.count;
+				});
+			edgesFrom[from->second].push_back(record);
+			});
+	}
+}
+
+void STBinaryWriter::Build(const SymbolTable& st, const CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	for (const auto* symbol : Sorted(st, true)) {
+		if (symbol->GetClassType() != ClassType::Structure)
+			continue;
+		structureIndex[symbol] = (uint32_t)structuresOrder.size();
+		structureIndexByID[symbol->GetID()] = (uint32_t)structuresOrder.size();
+		structuresOrder.push_back((const Structure*)symbol);
+	}
+	for (const auto* structure : structuresOrder)
+		AddStructure(structure);
+
+	AddDependencies(graph);
+
+	for (const auto& path : srcs)
+		codeFiles.push_back(String(path));
+	for (const auto& path : headers)
+		codeFiles.push_back(String(path));
+	headersCount = (uint32_t)headers.size();
+}
+
+// ----------------------------------------------------------------------------------------
+
+bool STBinaryWriter::Write(const std::string& path) const {
+	std::ofstream out(path, std::ios::binary);
+	if (!out.is_open())
+		return false;
+
+	Header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, ST_BINARY_MAGIC, 4);
+	header.version = ST_BINARY_VERSION;
+
+	uint64_t offset = sizeof(Header);
+	auto section = [&offset](SectionRecord& record, uint64_t count, size_t size) {
+		offset = (offset + 7) & ~(uint64_t)7;
+		record = { offset, count };
+		offset += count * size;
+	};
+	std::vector<uint32_t> rows = { 0 };
+	std::vector<EdgeRecord> edges;
+	for (const auto& from : edgesFrom) {
+		edges.insert(edges.end(), from.begin(), from.end());
+		rows.push_back((uint32_t)edges.size());
+	}
+
+	section(header.stringOffsets, stringOffsets.size(), sizeof(uint64_t));
+	section(header.stringData, stringData.size(), 1);
+	section(header.structures, structures.size(), sizeof(StructureRecord));
+	section(header.methods, methods.size(), sizeof(MethodRecord));
+	section(header.definitions, definitions.size(), sizeof(DefinitionRecord));
+	section(header.structureRefs, structureRefs.size(), sizeof(uint32_t));
+	section(header.dependencyRows, rows.size(), sizeof(uint32_t));
+	section(header.edges, edges.size(), sizeof(EdgeRecord));
+	section(header.edgeTypes, edgeTypes.size(), sizeof(EdgeTypeRecord));
+	section(header.sources, codeFiles.size() - headersCount, sizeof(uint32_t));
+	section(header.headers, headersCount, sizeof(uint32_t));
+
+	uint64_t written = 0;
+	auto write = [&out, &written](const SectionRecord& record, const void* data, size_t size) {
+		static const char padding[8] = {};
+		out.write(padding, record.offset - written);
+		out.write((const char*)data, size);
+		written = record.offset + size;
+	};
+	out.write((const char*)&header, sizeof(header));
+	written = sizeof(header);
+	write(header.stringOffsets, stringOffsets.data(), stringOffsets.size() * sizeof(uint64_t));
+	write(header.stringData, stringData.data(), stringData.size());
+	write(header.structures, structures.data(), structures.size() * sizeof(StructureRecord));
+	write(header.methods, methods.data(), methods.size() * sizeof(MethodRecord));
+	write(header.definitions, definitions.data(), definitions.size() * sizeof(DefinitionRecord));
+	write(header.structureRefs, structureRefs.data(), structureRefs.size() * sizeof(uint32_t));
+	write(header.dependencyRows, rows.data(), rows.size() * sizeof(uint32_t));
+	write(header.edges, edges.data(), edges.size() * sizeof(EdgeRecord));
+	write(header.edgeTypes, edgeTypes.data(), edgeTypes.size() * sizeof(EdgeTypeRecord));
+	write(header.sources, codeFiles.data(), header.sources.count * sizeof(uint32_t));
+	write(header.headers, codeFiles.data() + header.sources.count, header.headers.count * sizeof(uint32_t));
+	return (bool)out;
+}
+
+bool stBinary::WriteSTBinary(const std::string& path, const SymbolTable& st, const CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	STBinaryWriter writer;
+	writer.Build(st, graph, srcs, headers);
+	return writer.Write(path);
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+#include "CSRGraph.h"
+#include "STBinaryFormat.h"
+
+/*
+	Writes the binary ST (see STBinaryFormat.h): the structures of the SymbolTable, their methods and fields,
+	the dependencies of the Graph and the code files. As in ST.json, symbols without a source file are left out.
+*/
+
+namespace stBinary {
+
+	// Returns false if the file cannot be written
+	bool WriteSTBinary(const std::string& path, const dependenciesMining::SymbolTable& st, const graph::CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers);
+}
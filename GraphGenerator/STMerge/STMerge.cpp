@@ -0,0 +1,148 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
+#include <algorithm>
+#include "SymbolTable.h"
+#include "STSerialization.h"
+#include "GraphGeneration.h"
+#include "CSRGraph.h"
+#include "STToJson.h"
+#include "STBinaryWriter.h"
+#include "Arguments.h"
+
+/*
+	st-merge: combines the partial STs of the shards (main --shard i/N) into the ST of the whole codebase.
+	The partial STs are read and merged on worker threads: pairwise, in rounds (a tree), each merge
+	as SymbolTable::Merge does it (an Undefined placeholder is replaced by a definition, otherwise the first
+	definition wins and its member tables are completed). A pair merges the right table into the left one,
+	so the result is the one of merging the shards in the order given.
+	The dependency graph is then generated from the merged table and the ST written as main does.
+
+	argv[1]: path/to/ST-output
+	argv[2...]: paths/to/partial STs
+	--jobs N: worker threads (0: one per hardware thread, default: 0)
+	--binary-st PATH: also write the ST in binary form
+*/
+
+using namespace dependenciesMining;
+
+struct PartialST {
+	SymbolTable table;
+	std::vector<std::string> srcs;
+	std::vector<std::string> headers;
+};
+
+// Runs f(0) ... f(count - 1) on up to jobs threads
+template<typename F> static void ParallelFor(size_t count, unsigned jobs, const F& f) {
+	std::atomic<size_t> next{ 0 };
+	std::vector<std::thread> workers;
+	for (unsigned w = 0; w < std::min<size_t>(jobs, count); ++w) {
+		workers.emplace_back([&]() {
+			for (size_t i = next++; i < count; i = next++)
+				f(i);
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+// Merges all the tables into the first one
+static void TreeMerge(std::vector<PartialST>& partials, unsigned jobs) {
+	for (size_t step = 1; step < partials.size(); step *= 2) {
+		size_t pairs = (partials.size() - step + 2 * step - 1) / (2 * step);
+		ParallelFor(pairs, jobs, [&partials, step](size_t pair) {
+			size_t left = pair * 2 * step;
+			partials[left].table.Merge(partials[left + step].table);
+		});
+	}
+}
+
+// Every file once, in the order of the shards
+static void MergeFiles(std::vector<std::string>& merged, const std::vector<std::string>& files, std::unordered_set<std::string>& seen) {
+	for (const auto& file : files) {
+		if (seen.insert(file).second)
+			merged.push_back(file);
+	}
+}
+
+static bool Replace(const std::string& tempPath, const std::string& path) {
+	std::error_code error;
+	std::filesystem::rename(tempPath, path, error);
+	return !error;
+}
+
+int main(int argc, const char** argv) {
+	std::string jsonSTPath;
+	std::string binarySTPath;
+	std::vector<std::string> partialPaths;
+	unsigned jobs = 0;
+	bool validArgs = true;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--jobs" && i + 1 < argc && arguments::ParseUnsigned(argv[i + 1], jobs))
+			++i;
+		else if (arg == "--jobs")
+			validArgs = false;
+		else if (arg == "--binary-st" && i + 1 < argc)
+			binarySTPath = argv[++i];
+		else if (jsonSTPath == "")
+			jsonSTPath = arg;
+		else
+			partialPaths.push_back(arg);
+	}
+	if (!validArgs || jsonSTPath == "" || partialPaths.empty()) {
+		std::cout << "argv[1]: path/to/ST-output, argv[2...]: paths/to/partial STs (main --shard i/N)\n";
+		std::cout << "--jobs N: worker threads (0: one per hardware thread, default: 0)\n";
+		std::cout << "--binary-st PATH: also write the ST in binary form to PATH\n";
+		return 1;
+	}
+	if (jobs == 0)
+		jobs = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<PartialST> partials(partialPaths.size());
+	std::vector<char> read(partialPaths.size(), 0);
+	ParallelFor(partialPaths.size(), jobs, [&](size_t i) {
+		std::ifstream in(partialPaths[i], std::ios::binary);
+		read[i] = in.is_open() && ReadPartialST(in, partials[i].table, partials[i].srcs, partials[i].headers);
+	});
+	for (size_t i = 0; i < partialPaths.size(); ++i) {
+		if (!read[i]) {
+			std::cout << "Could not read the partial ST " << partialPaths[i] << "\n";
+			return 1;
+		}
+	}
+
+	std::vector<std::string> srcs, headers;
+	std::unordered_set<std::string> seenSrcs, seenHeaders;
+	for (const auto& partial : partials) {
+		MergeFiles(srcs, partial.srcs, seenSrcs);
+		MergeFiles(headers, partial.headers, seenHeaders);
+	}
+	TreeMerge(partials, jobs);
+	const auto& st = partials[0].table;
+
+	graph::CSRGraph graph(graphGeneration::GenetareDependenciesGraph(st));
+	std::string jsonSTTempPath = jsonSTPath + ".tmp";
+	std::ofstream jsonSTFile(jsonSTTempPath);
+	stToJson::WriteST(jsonSTFile, st, graph, srcs, headers);
+	jsonSTFile.close();
+	if (!jsonSTFile || !Replace(jsonSTTempPath, jsonSTPath)) {
+		std::cout << "Could not write the ST to " << jsonSTPath << "\n";
+		return 1;
+	}
+	if (binarySTPath != "") {
+		std::string binarySTTempPath = binarySTPath + ".tmp";
+		if (!stBinary::WriteSTBinary(binarySTTempPath, st, graph, srcs, headers) || !Replace(binarySTTempPath, binarySTPath)) {
+			std::cout << "Could not write the binary ST to " << binarySTPath << "\n";
+			return 1;
+		}
+	}
+	std::cout << partials.size() << " partial STs merged into " << jsonSTPath << "\n";
+	return 0;
+}
@@ -0,0 +1,151 @@
+#pragma warning(disable : 4996)
+#pragma warning(disable : 4146)
+#include <iostream>
+#include <sstream>
+#include "SymbolTable.h"
+#include "STSerialization.h"
+#include "GraphGeneration.h"
+#include "CSRGraph.h"
+#include "STToJson.h"
+
+/*
+	st-merge test: the ST of two shards (main --shard 0/2, 1/2) merged as st-merge does, compared with the ST
+	of a single process mining both TUs. It needs no clang: the tables are filled with the SymbolTable, Structure and
+	Method calls MineMethod makes, only the shard tables are merged (SymbolTable::Merge, as st-merge does).
+	Both TUs include header.h, which defines Header::f (its body is mined by both and differs per TU, as with
+	a macro defined per TU: the first TU wins) and declares Header::g,
+	defined in b.cpp only (mined without its body by a.cpp).
+	Also checks that an Undefined placeholder merged with the definition gives the definition, in both orders.
+	Returns 0 if the STs are the same.
+*/
+
+using namespace dependenciesMining;
+
+static Structure* InstallStructure(SymbolTable& table, const std::string& name, const std::string& fileName, int line) {
+	Structure structure(InternID(name), name, "", StructureType::Class, fileName, line, 1);
+	return (Structure*)table.Install(structure.GetID(), structure);
+}
+
+// The body of a method, as MineMethod mines it: once per table, by the first TU that defines it
+static void MineBody(Method* method, Structure* type, const std::string& fileName, int line, int metrics) {
+	if (method->IsBodyMined())
+		return;
+	for (int column = 3; column <= 1 + 2 * metrics; column += 2) {
+		std::string locBegin = fileName + ":" + std::to_string(line) + ":" + std::to_string(column);
+		Method::MemberExpr memberExpr("dep.value", SourceInfo(fileName, line, column + 9), fileName, line, column);
+		method->InsertMemberExpr(memberExpr, Method::Member("value", type, SourceInfo(fileName, line, column + 9)), locBegin);
+		method->InsertMemberExpr(memberExpr, Method::Member("dep", type, SourceInfo(fileName, line, column + 3)), locBegin);
+	}
+	method->SetAccessType(AccessType::_public);
+	method->SetLiterals(metrics);
+	method->SetStatements(metrics);
+	method->SetBranches(metrics);
+	method->SetLoops(metrics);
+	method->SetMaxScopeDepth(metrics);
+	method->SetLineCount(metrics);
+	method->SetBodyMined(true);
+}
+
+static Method* InstallMethod(Structure* parent, const std::string& name, const std::string& fileName, int line) {
+	Method method(InternID(name), name, "", fileName, line, 1);
+	method.SetMethodType(MethodType::UserMethod);
+	return (Method*)parent->InstallMethod(method.GetID(), method);
+}
+
+// What a TU contributes: header.h, then the structure of its own source
+static void MineTU(SymbolTable& table, const std::string& src) {
+	auto* dep = InstallStructure(table, "Dep", "dep.h", 1);
+	auto* header = InstallStructure(table, "Header", "header.h", 1);
+	MineBody(InstallMethod(header, "Header::f", "header.h", 3), dep, "header.h", 4, src == "a.cpp" ? 2 : 4);
+	auto* g = InstallMethod(header, "Header::g", "header.h", 6);
+	if (src == "b.cpp")
+		MineBody(g, dep, "b.cpp", 2, 3);
+
+	std::string name = src == "a.cpp" ? "A" : "B";
+	auto* own = InstallStructure(table, name, src, 5);
+	MineBody(InstallMethod(own, name + "::h", src, 6), header, src, 7, 1);
+}
+
+// P defined with its field, or only referenced by User (an Undefined placeholder, which got a member)
+static void MinePlaceholderTU(SymbolTable& table, bool defined) {
+	auto* dep = InstallStructure(table, "Dep", "dep.h", 1);
+	Structure* p;
+	if (defined) {
+		p = InstallStructure(table, "P", "p.h", 1);
+		Definition x(InternID("P::x"), "P::x", "", dep, "p.h", 2, 2);
+		p->InstallField(x.GetID(), x);
+	}
+	else {
+		p = (Structure*)table.Install(InternID("P"), "P");
+		Definition stale(InternID("P::stale"), "P::stale", "", dep, "user.h", 3, 3);
+		p->InstallField(stale.GetID(), stale);
+	}
+	auto* user = InstallStructure(table, "User", "user.h", 1);
+	Definition field(InternID("User::p"), "User::p", "", p, "user.h", 2, 2);
+	user->InstallField(field.GetID(), field);
+}
+
+static std::string ToJson(const SymbolTable& st, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	graph::CSRGraph graph(graphGeneration::GenetareDependenciesGraph(st));
+	std::ostringstream out;
+	stToJson::WriteST(out, st, graph, srcs, headers);
+	return out.str();
+}
+
+static bool MergesPlaceholders() {
+	std::vector<std::string> srcs = { "p.cpp", "user.cpp" };
+	std::vector<std::string> headers = { "dep.h", "p.h", "user.h" };
+	SymbolTable defined;
+	MinePlaceholderTU(defined, true);
+	std::string expected = ToJson(defined, srcs, headers);
+
+	bool same = true;
+	for (bool placeholderFirst : { true, false }) {
+		SymbolTable left, right;
+		MinePlaceholderTU(left, !placeholderFirst);
+		MinePlaceholderTU(right, placeholderFirst);
+		left.Merge(right);
+		if (ToJson(left, srcs, headers) != expected) {
+			std::cout << "FAILED: the " << (placeholderFirst ? "placeholder" : "definition") << " merged first does not give the definition\n";
+			same = false;
+		}
+	}
+	return same;
+}
+
+int main() {
+	if (!MergesPlaceholders())
+		return 1;
+
+	std::vector<std::string> srcs = { "a.cpp", "b.cpp" };
+	std::vector<std::string> headers = { "dep.h", "header.h" };
+
+	SymbolTable single;
+	for (const auto& src : srcs)
+		MineTU(single, src);
+	std::string expected = ToJson(single, srcs, headers);
+
+	// A pair of partial STs is merged by st-merge as the right one into the left one
+	SymbolTable partials[2];
+	for (int shard = 0; shard < 2; ++shard) {
+		SymbolTable shardTable;
+		MineTU(shardTable, srcs[shard]);
+		std::stringstream file;
+		WritePartialST(file, shardTable, { srcs[shard] }, headers);
+		std::vector<std::string> shardSrcs, shardHeaders;
+		if (!ReadPartialST(file, partials[shard], shardSrcs, shardHeaders)) {
+			std::cout << "FAILED: could not read the partial ST of shard " << shard << "\n";
+			return 1;
+		}
+	}
+	partials[0].Merge(partials[1]);
+	std::string merged = ToJson(partials[0], srcs, headers);
+
+	if (merged != expected) {
+		std::cout << "FAILED: the merged ST differs from the single process ST\n";
+		std::cout << "--- single process\n" << expected << "\n--- merged\n" << merged << "\n";
+		return 1;
+	}
+	std::cout << "OK: the merged ST is the single process ST\n";
+	return 0;
+}
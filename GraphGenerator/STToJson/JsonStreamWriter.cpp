@@ -0,0 +1,189 @@
+#include "JsonStreamWriter.h"
+#include <cassert>
+
+using namespace stToJson;
+
+void JsonStreamWriter::WriteIndent() {
+	out << '\n' << indentString;
+}
+
+void JsonStreamWriter::WriteWithIndent(const char* str) {
+	if (!indented)
+		WriteIndent();
+	out << str;
+	indented = false;
+}
+
+// Array elements start on their own line, object members are started by Key
+void JsonStreamWriter::BeginValue() {
+	if (containers.empty() || !containers.back().isArray)
+		return;
+	OpenContainer();
+	auto& array = containers.back();
+	if (array.size++)
+		out << ",";
+	if (!indented)
+		WriteIndent();
+	indented = true;
+}
+
+void JsonStreamWriter::EndValue() {
+	if (!containers.empty() && containers.back().isArray)
+		indented = false;
+}
+
+// The brace is written with the first member, an empty container is written as "{}" / "[]"
+void JsonStreamWriter::OpenContainer() {
+	auto& container = containers.back();
+	if (container.isOpen)
+		return;
+	container.isOpen = true;
+	WriteWithIndent(container.isArray ? "[" : "{");
+	indentString.push_back('\t');
+}
+
+void JsonStreamWriter::WriteQuoted(const std::string& str) {
+	static const char* hex = "0123456789abcdef";
+	auto writeU16 = [this](unsigned code) {
+		out << "\\u" << hex[(code >> 12) & 0xF] << hex[(code >> 8) & 0xF] << hex[(code >> 4) & 0xF] << hex[code & 0xF];
+	};
+	out << '"';
+	const char* end = str.data() + str.size();
+	for (const char* cur = str.data(); cur < end; ++cur) {
+		unsigned char c = *cur;
+		switch (c) {
+		case '\"': out << "\\\""; continue;
+		case '\\': out << "\\\\"; continue;
+		case '\b': out << "\\b"; continue;
+		case '\f': out << "\\f"; continue;
+		case '\n': out << "\\n"; continue;
+		case '\r': out << "\\r"; continue;
+		case '\t': out << "\\t"; continue;
+		}
+		if (c < 0x20) {
+			writeU16(c);
+			continue;
+		}
+		if (c < 0x80) {
+			out << (char)c;
+			continue;
+		}
+		// non ASCII: utf-8 decoded and escaped (invalid sequences as U+FFFD), as jsoncpp does
+		unsigned code = 0xFFFD;
+		auto next = [&cur](int i) { return (unsigned)(unsigned char)cur[i] & 0x3F; };
+		if (c < 0xE0) {
+			if (end - cur >= 2) {
+				code = ((c & 0x1F) << 6) | next(1);
+				cur += 1;
+				if (code < 0x80)
+					code = 0xFFFD;
+			}
+		}
+		else if (c < 0xF0) {
+			if (end - cur >= 3) {
+				code = ((c & 0x0F) << 12) | (next(1) << 6) | next(2);
+				cur += 2;
+				if (code < 0x800 || (code >= 0xD800 && code <= 0xDFFF))
+					code = 0xFFFD;
+			}
+		}
+		else if (c < 0xF8) {
+			if (end - cur >= 4) {
+				code = ((c & 0x07) << 18) | (next(1) << 12) | (next(2) << 6) | next(3);
+				cur += 3;
+				if (code < 0x10000)
+					code = 0xFFFD;
+			}
+		}
+		if (code < 0x10000) {
+			writeU16(code);
+		}
+		else {
+			code -= 0x10000;
+			writeU16(0xD800 + ((code >> 10) & 0x3FF));
+			writeU16(0xDC00 + (code & 0x3FF));
+		}
+	}
+	out << '"';
+}
+
+// ----------------------------------------------------------------------------------------
+
+void JsonStreamWriter::StartObject() {
+	BeginValue();
+	containers.push_back({ false });
+}
+
+void JsonStreamWriter::EndObject() {
+	assert(!containers.empty() && !containers.back().isArray);
+	bool isOpen = containers.back().isOpen;
+	containers.pop_back();
+	if (isOpen) {
+		indentString.pop_back();
+		WriteWithIndent("}");
+	}
+	else {
+		out << "{}";
+	}
+	EndValue();
+}
+
+void JsonStreamWriter::StartArray() {
+	BeginValue();
+	containers.push_back({ true });
+}
+
+void JsonStreamWriter::EndArray() {
+	assert(!containers.empty() && containers.back().isArray);
+	bool isOpen = containers.back().isOpen;
+	containers.pop_back();
+	if (isOpen) {
+		indentString.pop_back();
+		WriteWithIndent("]");
+	}
+	else {
+		out << "[]";
+	}
+	EndValue();
+}
+
+void JsonStreamWriter::Key(const std::string& key) {
+	assert(!containers.empty() && !containers.back().isArray);
+	OpenContainer();
+	if (containers.back().size++)
+		out << ",";
+	WriteIndent();
+	WriteQuoted(key);
+	out << " : ";
+	indented = false;
+}
+
+void JsonStreamWriter::String(const std::string& value) {
+	BeginValue();
+	WriteQuoted(value);
+	EndValue();
+}
+
+void JsonStreamWriter::Int(int64_t value) {
+	BeginValue();
+	out << value;
+	EndValue();
+}
+
+void JsonStreamWriter::UInt(uint64_t value) {
+	BeginValue();
+	out << value;
+	EndValue();
+}
+
+void JsonStreamWriter::Bool(bool value) {
+	BeginValue();
+	out << (value ? "true" : "false");
+	EndValue();
+}
+
+void JsonStreamWriter::Null() {
+	BeginValue();
+	out << "null";
+	EndValue();
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+	SAX style json writer, writes straight to the stream (nothing is kept but the open containers).
+	The output is the same as writing the equivalent Json::Value with operator<< (tab indentation,
+	" : " after keys, "{}"/"[]" for empty containers), so the caller must give the object keys sorted,
+	as Json::Value keeps them.
+*/
+
+namespace stToJson {
+
+	class JsonStreamWriter {
+	private:
+		struct Container {
+			bool isArray;
+			bool isOpen = false;							// "{" / "[" written (the container is not empty)
+			unsigned size = 0;
+		};
+
+		std::ostream& out;
+		std::string indentString;
+		bool indented = true;
+		std::vector<Container> containers;
+
+		void WriteIndent();
+		void WriteWithIndent(const char* str);
+		void BeginValue();
+		void EndValue();
+		void OpenContainer();
+		void WriteQuoted(const std::string& str);
+
+	public:
+		JsonStreamWriter(std::ostream& out) : out(out) {};
+
+		void StartObject();
+		void EndObject();
+		void StartArray();
+		void EndArray();
+		void Key(const std::string& key);
+
+		void String(const std::string& value);
+		void Int(int64_t value);
+		void UInt(uint64_t value);
+		void Bool(bool value);
+		void Null();
+	};
+}
@@ -0,0 +1,206 @@
+#include "STToJson.h"
+#include "JsonStreamWriter.h"
+#include <algorithm>
+
+using namespace stToJson;
+using namespace dependenciesMining;
+using namespace graph;
+
+namespace {
+
+	class STJsonWriter {
+	private:
+		JsonStreamWriter& json;
+
+		void WriteSourceInfo(const Symbol* symbol);
+		void WriteStructure(const Structure* structure);
+		void WriteMethod(const Method* method);
+		void WriteDefinition(const Definition* definition);
+
+	public:
+		STJsonWriter(JsonStreamWriter& json) : json(json) {};
+		void WriteSymbolTable(const SymbolTable& st);
+	};
+}
+
+// Edges as {from, to, types}, in the order of the graph nodes
+static void WriteDependencies(JsonStreamWriter& json, const CSRGraph& graph) {
+	for (CSRGraph::Index node = 0; node < graph.NodesSize(); ++node) {
+		const auto& from = GetIDString(graph.GetID(node));
+		graph.ForEachEdge(node, [&](CSRGraph::Index edge, CSRGraph::Index to) {
+			json.StartObject();
+			json.Key("from");
+			json.String(from);
+			json.Key("to");
+			json.String(GetIDString(graph.GetID(to)));
+			json.Key("types");
+			bool hasTypes = false;
+			graph.ForEachDependency(edge, [&](Edge::DependencyType depType, Edge::Cardinality card) {
+				if (!hasTypes)
+					json.StartObject();
+				hasTypes = true;
+				json.Key(GetDependencyTypeName(depType));
+				json.UInt(card);
+				});
+			if (hasTypes)
+				json.EndObject();
+			else
+				json.Null();
+			json.EndObject();
+			});
+	}
+}
+
+// ----------------------------------------------------------------------------------------
+
+void STJsonWriter::WriteSourceInfo(const Symbol* symbol) {
+	const auto& srcInfo = symbol->GetSourceInfo();
+	json.StartObject();
+	json.Key("col");
+	json.Int(srcInfo.GetColumn());
+	json.Key("file");
+	json.String(srcInfo.GetFileName());
+	json.Key("line");
+	json.Int(srcInfo.GetLine());
+	json.EndObject();
+}
+
+void STJsonWriter::WriteStructure(const Structure* structure) {
+	json.StartObject();
+	const auto& bases = structure->GetBases();
+	if (bases.begin() != bases.end()) {
+		json.Key("bases");
+		json.StartArray();
+		for (const auto& base : bases) {
+			json.String(GetIDString(base.second->GetID()));
+		}
+		json.EndArray();
+	}
+	json.Key("contains");
+	WriteSymbolTable(structure->GetContains());
+	json.Key("fields");
+	WriteSymbolTable(structure->GetFields());
+	json.Key("friends");
+	WriteSymbolTable(structure->GetFriends());
+	json.Key("methods");
+	WriteSymbolTable(structure->GetMethods());
+	json.Key("src_info");
+	WriteSourceInfo(structure);
+	json.EndObject();
+}
+
+void STJsonWriter::WriteMethod(const Method* method) {
+	json.StartObject();
+	json.Key("access");
+	json.String(method->GetAccessTypeStr());
+	json.Key("args");
+	WriteSymbolTable(method->GetArguments());
+	json.Key("branches");
+	json.Int(method->GetBranches());
+	json.Key("definitions");
+	WriteSymbolTable(method->GetDefinitions());
+	json.Key("lines");
+	json.Int(method->GetLineCount());
+	json.Key("literals");
+	json.Int(method->GetLiterals());
+	json.Key("loops");
+	json.Int(method->GetLoops());
+	json.Key("max_scope");
+	json.Int(method->GetMaxScopeDepth());
+	json.Key("ret_type");
+	auto* retType = method->GetReturnType();
+	json.String(retType ? GetIDString(retType->GetID()) : "void");
+	json.Key("src_info");
+	WriteSourceInfo(method);
+	json.Key("statements");
+	json.Int(method->GetStatements());
+	json.Key("template_args");
+	WriteSymbolTable(method->GetTemplateArguments());
+	json.Key("virtual");
+	json.Bool(method->IsVirtual());
+	json.EndObject();
+}
+
+void STJsonWriter::WriteDefinition(const Definition* definition) {
+	json.StartObject();
+	if (definition->GetAccessType() != AccessType::unknown) {
+		json.Key("access");
+		json.String(definition->GetAccessTypeStr());
+	}
+	json.Key("type");
+	json.String(definition->GetFullType());
+	json.EndObject();
+}
+
+// Symbols without a source file are skipped, a table with no symbols left is null
+void STJsonWriter::WriteSymbolTable(const SymbolTable& st) {
+	std::vector<std::pair<const std::string*, const Symbol*>> symbols;
+	for (const auto& it : st) {
+		if (it.second->GetSourceInfo().GetFileName() == "")
+			continue;
+		symbols.emplace_back(&GetIDString(it.second->GetID()), it.second);
+	}
+	if (symbols.empty()) {
+		json.Null();
+		return;
+	}
+	std::sort(symbols.begin(), symbols.end(), [](const auto& a, const auto& b) { return *a.first < *b.first; });
+
+	json.StartObject();
+	for (const auto& it : symbols) {
+		json.Key(*it.first);
+		auto* symbol = it.second;
+		if (symbol->GetClassType() == ClassType::Structure) {
+			WriteStructure((const Structure*)symbol);
+		}
+		else if (symbol->GetClassType() == ClassType::Definition) {
+			WriteDefinition((const Definition*)symbol);
+		}
+		else if (symbol->GetClassType() == ClassType::Method) {
+			WriteMethod((const Method*)symbol);
+		}
+		else if (symbol->GetClassType() == ClassType::Undefined) {
+			json.Null();
+		}
+		else
+			assert(0);
+	}
+	json.EndObject();
+}
+
+// ----------------------------------------------------------------------------------------
+
+void stToJson::WriteST(std::ostream& out, const SymbolTable& st, const CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers) {
+	JsonStreamWriter json(out);
+	json.StartObject();
+
+	json.Key("dependencies");
+	if (graph.EdgesSize()) {
+		json.StartArray();
+		WriteDependencies(json, graph);
+		json.EndArray();
+	}
+	else {
+		json.Null();
+	}
+
+	if (!headers.empty()) {
+		json.Key("headers");
+		json.StartArray();
+		for (const auto& path : headers)
+			json.String(path);
+		json.EndArray();
+	}
+	if (!srcs.empty()) {
+		json.Key("sources");
+		json.StartArray();
+		for (const auto& path : srcs)
+			json.String(path);
+		json.EndArray();
+	}
+
+	json.Key("structures");
+	STJsonWriter(json).WriteSymbolTable(st);
+
+	json.EndObject();
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SymbolTable.h"
+#include "CSRGraph.h"
+
+/*
+	Writes ST.json (structures, dependencies, sources, headers) while walking the SymbolTable and the Graph,
+	no Json::Value of the model is built. Same output as filling a Json::Value with SymbolTable::AddJsonSymbolTable
+	and the graph edges, and writing it with operator<<.
+*/
+
+namespace stToJson {
+
+	void WriteST(std::ostream& out, const dependenciesMining::SymbolTable& st, const graph::CSRGraph& graph, const std::vector<std::string>& srcs, const std::vector<std::string>& headers);
+}
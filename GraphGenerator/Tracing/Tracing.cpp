@@ -0,0 +1,269 @@
+#include "Tracing.h"
+#include "JsonStreamWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+using namespace tracing;
+
+namespace {
+
+	struct Event {
+		Category category;
+		std::string name;
+		uint64_t start;									// wall, since Enable
+		uint64_t wall;
+		uint64_t cpu;
+	};
+
+	struct TotalStats {
+		uint64_t count = 0;
+		uint64_t wall = 0;
+		uint64_t cpu = 0;
+	};
+
+	// Written only by its thread, read once the threads are done
+	struct ThreadData {
+		unsigned tid;
+		std::vector<Event> events;
+		std::unordered_map<const char*, TotalStats> totals;
+	};
+
+	struct Session {
+		std::atomic<bool> enabled{ false };
+		std::chrono::steady_clock::time_point start;
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ThreadData>> threads;
+	};
+
+	Session& GetSession() {
+		static Session session;
+		return session;
+	}
+
+	thread_local ThreadData* threadData = nullptr;
+
+	ThreadData& GetThreadData() {
+		if (!threadData) {
+			auto& session = GetSession();
+			std::lock_guard<std::mutex> lock(session.mutex);
+			session.threads.push_back(std::make_unique<ThreadData>());
+			threadData = session.threads.back().get();
+			threadData->tid = (unsigned)session.threads.size();
+		}
+		return *threadData;
+	}
+
+	uint64_t WallMicroseconds() {
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - GetSession().start).count();
+	}
+
+	uint64_t CPUMicroseconds() {
+#ifdef _WIN32
+		FILETIME creation, exit, kernel, user;
+		if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+			return 0;
+		uint64_t kernelTime = ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+		uint64_t userTime = ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+		return (kernelTime + userTime) / 10;						// 100ns units
+#else
+		timespec time;
+		if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time))
+			return 0;
+		return (uint64_t)time.tv_sec * 1000000 + time.tv_nsec / 1000;
+#endif
+	}
+
+	double Ms(uint64_t microseconds) {
+		return microseconds / 1000.0;
+	}
+
+	// The totals of all the threads, by name
+	std::vector<std::pair<std::string, TotalStats>> GetTotals() {
+		std::unordered_map<const char*, TotalStats> totals;
+		for (const auto& thread : GetSession().threads) {
+			for (const auto& it : thread->totals) {
+				auto& total = totals[it.first];
+				total.count += it.second.count;
+				total.wall += it.second.wall;
+				total.cpu += it.second.cpu;
+			}
+		}
+		std::vector<std::pair<std::string, TotalStats>> sorted(totals.begin(), totals.end());
+		std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		return sorted;
+	}
+}
+
+void tracing::Enable() {
+	auto& session = GetSession();
+	if (session.enabled)
+		return;
+	session.start = std::chrono::steady_clock::now();
+	session.enabled = true;
+}
+
+bool tracing::IsEnabled() {
+	return GetSession().enabled.load(std::memory_order_relaxed);
+}
+
+const char* tracing::GetCategoryName(Category category) {
+	switch (category) {
+		case Category::Phase: return "Phase";
+		case Category::TranslationUnit: return "TranslationUnit";
+		default:
+			assert(0);
+			return "";
+	}
+}
+
+// ----------------------------------------------------------------------------------------
+
+Scope::Scope(Category category, std::string name) : category(category) {
+	if (!IsEnabled())
+		return;
+	this->name = std::move(name);
+	open = true;
+	wallStart = WallMicroseconds();
+	cpuStart = CPUMicroseconds();
+}
+
+void Scope::End() {
+	if (!open)
+		return;
+	open = false;
+	uint64_t cpu = CPUMicroseconds() - cpuStart;
+	uint64_t wall = WallMicroseconds() - wallStart;
+	GetThreadData().events.push_back({ category, std::move(name), wallStart, wall, cpu });
+}
+
+Total::Total(const char* name) : name(name) {
+	if (!IsEnabled())
+		return;
+	open = true;
+	wallStart = WallMicroseconds();
+	cpuStart = CPUMicroseconds();
+}
+
+Total::~Total() {
+	if (!open)
+		return;
+	uint64_t cpu = CPUMicroseconds() - cpuStart;
+	uint64_t wall = WallMicroseconds() - wallStart;
+	auto& total = GetThreadData().totals[name];
+	total.count++;
+	total.wall += wall;
+	total.cpu += cpu;
+}
+
+// ----------------------------------------------------------------------------------------
+
+void tracing::WriteChromeTrace(std::ostream& out) {
+	stToJson::JsonStreamWriter json(out);
+	json.StartObject();
+
+	json.Key("displayTimeUnit");
+	json.String("ms");
+
+	json.Key("otherData");
+	json.StartObject();
+	for (const auto& it : GetTotals()) {
+		json.Key(it.first);
+		json.StartObject();
+		json.Key("count");
+		json.UInt(it.second.count);
+		json.Key("cpu_us");
+		json.UInt(it.second.cpu);
+		json.Key("wall_us");
+		json.UInt(it.second.wall);
+		json.EndObject();
+	}
+	json.EndObject();
+
+	json.Key("traceEvents");
+	json.StartArray();
+	for (const auto& thread : GetSession().threads) {
+		for (const auto& event : thread->events) {
+			json.StartObject();
+			json.Key("args");
+			json.StartObject();
+			json.Key("cpu_us");
+			json.UInt(event.cpu);
+			json.EndObject();
+			json.Key("cat");
+			json.String(GetCategoryName(event.category));
+			json.Key("dur");
+			json.UInt(event.wall);
+			json.Key("name");
+			json.String(event.name);
+			json.Key("ph");
+			json.String("X");
+			json.Key("pid");
+			json.UInt(1);
+			json.Key("tid");
+			json.UInt(thread->tid);
+			json.Key("ts");
+			json.UInt(event.start);
+			json.EndObject();
+		}
+	}
+	json.EndArray();
+
+	json.EndObject();
+}
+
+bool tracing::WriteChromeTrace(const std::string& path) {
+	std::ofstream out(path);
+	if (!out)
+		return false;
+	WriteChromeTrace(out);
+	out.close();
+	return (bool)out;
+}
+
+void tracing::PrintSummary(std::ostream& out, unsigned slowestTUs) {
+	std::vector<const Event*> phases, tus;
+	uint64_t tusWall = 0, tusCPU = 0;
+	for (const auto& thread : GetSession().threads) {
+		for (const auto& event : thread->events) {
+			if (event.category == Category::Phase) {
+				phases.push_back(&event);
+			}
+			else {
+				tus.push_back(&event);
+				tusWall += event.wall;
+				tusCPU += event.cpu;
+			}
+		}
+	}
+	std::sort(phases.begin(), phases.end(), [](const Event* a, const Event* b) { return a->start < b->start; });
+	std::sort(tus.begin(), tus.end(), [](const Event* a, const Event* b) { return a->wall > b->wall; });
+
+	auto precision = out.precision();
+	out << std::fixed << std::setprecision(1);
+	out << "Phases (wall ms, cpu ms)\n";
+	for (const auto* event : phases)
+		out << "\t" << event->name << ": " << Ms(event->wall) << ", " << Ms(event->cpu) << "\n";
+
+	out << "Translation units: " << tus.size() << " (wall ms, cpu ms: " << Ms(tusWall) << ", " << Ms(tusCPU) << "), slowest:\n";
+	for (size_t i = 0; i < tus.size() && i < slowestTUs; ++i)
+		out << "\t" << tus[i]->name << ": " << Ms(tus[i]->wall) << ", " << Ms(tus[i]->cpu) << "\n";
+
+	out << "Totals (count, wall ms, cpu ms, wall us per call)\n";
+	for (const auto& it : GetTotals())
+		out << "\t" << it.first << ": " << it.second.count << ", " << Ms(it.second.wall) << ", " << Ms(it.second.cpu) << ", " << (double)it.second.wall / std::max<uint64_t>(1, it.second.count) << "\n";
+	out << std::defaultfloat << std::setprecision(precision);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/*
+	Wall and CPU time of the phases of a run, of each TU and of each mining callback type.
+	Disabled by default: until Enable is called the scopes cost a flag check.
+	Scopes are recorded as Chrome trace events (chrome://tracing, Perfetto),
+	Totals only add up (count, wall, cpu) per name: they time calls too short and too many to be events.
+	The CPU time is the one of the thread that ran the scope.
+*/
+
+namespace tracing {
+
+	enum class Category : unsigned {
+		Phase,
+		TranslationUnit,
+		Count
+	};
+
+	void Enable();
+	bool IsEnabled();
+
+	// An event from construction to destruction (or End)
+	class Scope {
+	private:
+		Category category;
+		std::string name;
+		uint64_t wallStart = 0;
+		uint64_t cpuStart = 0;
+		bool open = false;
+	public:
+		Scope(Category category, std::string name);
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		~Scope() { End(); }
+		void End();
+	};
+
+	// Adds the time from construction to destruction to the total of name (a string literal, totals are kept by pointer)
+	class Total {
+	private:
+		const char* name;
+		uint64_t wallStart = 0;
+		uint64_t cpuStart = 0;
+		bool open = false;
+	public:
+		Total(const char* name);
+		Total(const Total&) = delete;
+		Total& operator=(const Total&) = delete;
+		~Total();
+	};
+
+	// Chrome trace event format (complete "X" events, times in microseconds), the totals under "otherData"
+	void WriteChromeTrace(std::ostream& out);
+	bool WriteChromeTrace(const std::string& path);
+
+	// The phases in order, the (slowest) TUs and the totals
+	void PrintSummary(std::ostream& out = std::cout, unsigned slowestTUs = 10);
+	const char* GetCategoryName(Category category);
+}
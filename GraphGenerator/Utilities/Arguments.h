@@ -0,0 +1,37 @@
+#pragma once
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <string>
+
+// Strict parsing of the numeric command line arguments of main and st-merge
+
+namespace arguments {
+
+	// A whole decimal number (no sign, nothing after it) that fits in an unsigned
+	inline bool ParseUnsigned(const char* str, unsigned& value) {
+		if (*str < '0' || *str > '9')
+			return false;
+		char* end;
+		errno = 0;
+		unsigned long parsed = std::strtoul(str, &end, 10);
+		if (*end != '\0' || errno == ERANGE || parsed > UINT_MAX)
+			return false;
+		value = (unsigned)parsed;
+		return true;
+	}
+
+	// i/N with i < N
+	inline bool ParseShard(const char* str, unsigned& index, unsigned& count) {
+		std::string shard = str;
+		auto slash = shard.find('/');
+		if (slash == std::string::npos)
+			return false;
+		unsigned parsedIndex, parsedCount;
+		if (!ParseUnsigned(shard.substr(0, slash).c_str(), parsedIndex) || !ParseUnsigned(shard.substr(slash + 1).c_str(), parsedCount) || parsedIndex >= parsedCount)
+			return false;
+		index = parsedIndex;
+		count = parsedCount;
+		return true;
+	}
+}
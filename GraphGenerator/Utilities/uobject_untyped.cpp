@@ -9,7 +9,7 @@
 
 namespace untyped {
 
-Object::Object(const Object& other) {
+Object::Object(const Object& other) : elements(other.elements) {
     values.insert(
 		other.values.begin(), 
 		other.values.end()
@@ -22,12 +22,7 @@ bool Object::operator==(const Object& other) const {
 	if (this == &other)
 		return true;
 	else
-		return	values.size() == other.values.size() && 
-				std::equal(
-					values.begin(), 
-					values.end(), 
-					other.values.begin()
-				);
+		return	elements == other.elements && values == other.values;
 }
 
 const Value& Object::operator[](const Value& key) const 
@@ -35,10 +30,42 @@ const Value& Object::operator[](const Value& key) const
 
 //---------------------------------------------------------------
 
-bool Object::In (const Value& key) const 
-	{ return values.find(key) != values.end(); }
+bool Object::IsElement (const Value& key, util_ui32* index) const {
+	if (!key.IsNumber())
+		return false;
+	double number = key.ToNumber();
+	if (number < 0 || number >= elements.size() || number != (double) (util_ui32) number)
+		return false;
+	*index = (util_ui32) number;
+	return true;
+}
+
+bool Object::IsNextElement (const Value& key) const
+	{ return key.IsNumber() && key.ToNumber() == (double) elements.size(); }
+
+// Appends and takes over the next indices that were set out of order
+void Object::AppendElement (Value&& value) {
+	elements.push_back(std::move(value));
+	while (!values.empty()) {
+		auto i = values.find(Value((double) elements.size()));
+		if (i == values.end())
+			break;
+		elements.push_back(std::move(i->second));
+		values.erase(i);
+	}
+}
+
+//---------------------------------------------------------------
+
+bool Object::In (const Value& key) const {
+	util_ui32 index;
+	return IsElement(key, &index) || values.find(key) != values.end(); 
+}
 
 const Value& Object::Get (const Value& key) const {
+	util_ui32 index;
+	if (IsElement(key, &index))
+		return elements[index];
     auto i = values.find(key);	
     DASSERT(i != values.end());
     return i->second;
@@ -46,21 +73,43 @@ const Value& Object::Get (const Value& key) const {
 
 //---------------------------------------------------------------
 
-Object& Object::Set (const Value& key, const Value& value) {
+Object& Object::Set (const Value& key, const Value& value) 
+	{ return Set(key, Value(value)); }
+
+Object& Object::Set (const Value& key, Value&& value) {
+
+	util_ui32 index;
+	if (IsElement(key, &index)) {
+		elements[index] = std::move(value);
+		return *this;
+	}
+	if (IsNextElement(key)) {
+		AppendElement(std::move(value));
+		return *this;
+	}
 
     auto i = values.find(key);
     if (i != values.end())
-        i->second = value;
+        i->second = std::move(value);
     else
-        values.insert({key, value});
+        values.emplace(key, std::move(value));
 
     return *this;
 }
 
 //---------------------------------------------------------------
 
+// Removing an element moves the elements after it to values
 Object& Object::RemoveValue (const Value& key) {
 
+	util_ui32 index;
+	if (IsElement(key, &index)) {
+		for (util_ui32 j = index + 1; j < elements.size(); ++j)
+			values.emplace(Value((double) j), std::move(elements[j]));
+		elements.resize(index);
+		return *this;
+	}
+
     auto i = values.find(key);
 	DASSERT(i != values.end());
 	values.erase(i);
@@ -7,6 +7,7 @@
 
 #include "uvalue_untyped.h"
 #include <unordered_map>
+#include <vector>
 
 //---------------------------------------------------------------
 
@@ -22,7 +23,7 @@ class UTILLIB_CLASS Object {
 	public:
     Object (void) = default;
     Object (const Object& other);
-	Object (Object&& other) : values(other.values){}
+	Object (Object&& other) noexcept : elements(std::move(other.elements)), values(std::move(other.values)){}
 	~Object() { Clear(); }
 
 	UOVERLOADED_ASSIGN_VIA_COPY_CONSTRUCTOR(Object)
@@ -36,13 +37,16 @@ class UTILLIB_CLASS Object {
     const Value&	Get (const Value& key) const;
 	const Value&	operator[](const Value& key) const; 
     Object&			Set (const Value& key, const Value& value);
+    Object&			Set (const Value& key, Value&& value);
     Object&			RemoveValue (const Value& key);
 	void			Clear (void) 
-						{ values.clear(); }
+						{ elements.clear(); values.clear(); }
 	util_ui32		GetTotal (void) const
-						{ return (util_ui32) values.size(); }
+						{ return (util_ui32) (elements.size() + values.size()); }
 	template <typename Tfunc>
-	void			ForEach (const Tfunc& f) const {
+	void			ForEach (const Tfunc& f) const {	// the dense indices first, in order
+						for (util_ui32 i = 0; i < elements.size(); ++i)
+							f(Value((double) i), elements[i]);
 						for (auto& i : values)
 							f(i.first, i.second);
 					}
@@ -51,7 +55,15 @@ class UTILLIB_CLASS Object {
 
 	private:
     using ValueMap = std::unordered_map<const Value, Value, ValueHash>;
+
+	// Number keys 0, 1, ..., n - 1 (as set by Set(index++, ...)) are kept in elements, 
+	// never in values, all the other keys in values.
+	std::vector<Value> elements;
     ValueMap values;
+
+	bool			IsElement (const Value& key, util_ui32* index) const;
+	bool			IsNextElement (const Value& key) const;
+	void			AppendElement (Value&& value);
 };
 
 } // untyped
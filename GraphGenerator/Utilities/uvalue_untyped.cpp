@@ -15,12 +15,10 @@ Value::Value (void)
 	{ value.type = Type::Undefined; }
 
 Value::Value (const Value& other) 
-	{ InitialiseFrom(other, true); }
+	{ InitialiseFrom(other); }
 
-Value::Value (Value&& other)  {
-    InitialiseFrom(other, false);
-    other.Nullify();
-}
+Value::Value (Value&& other) noexcept
+	{ MoveFrom(other); }
 
 Value::~Value() 
 	{ Clear(); }
@@ -52,8 +50,11 @@ bool Value::operator==(const Value& other) const {
 			case Type::Reference:
 				return value.referenceValue == other.value.referenceValue;
 
+			case Type::ConstReference:
+				return value.constReferenceValue == other.value.constReferenceValue;
+
 			case Type::String:
-				return *DPTR(value.stringValue) == *DPTR(other.value.stringValue);
+				return String() == other.String();
 
 			case Type::Object:
 				return *DPTR(value.objectValue) == *DPTR(other.value.objectValue);
@@ -83,9 +84,24 @@ Value& Value::FromNumber (double number) {
 //---------------------------------------------------------------
 
 Value& Value::FromString (const std::string& from) {
-    Clear();
-    value.type = Type::String;
-    value.stringValue = DNEWCLASS(std::string, (from));
+	if (IsString())
+		String() = from;
+	else {
+		Clear();
+		new (value.stringValue) std::string(from);
+		value.type = Type::String;
+	}
+	return *this;
+}
+
+Value& Value::FromString (std::string&& from) {
+	if (IsString())
+		String() = std::move(from);
+	else {
+		Clear();
+		new (value.stringValue) std::string(std::move(from));
+		value.type = Type::String;
+	}
 	return *this;
 }
 
@@ -129,12 +145,26 @@ Value& Value::FromObject (const Object& object) {
 
 //---------------------------------------------------------------
 
+Value& Value::FromObject (Object&& object) {
+	if (!IsObject() || &ToObject() != &object) {
+		Clear();
+		value.type = Type::Object;
+		value.objectValue = DNEWCLASS(Object, (std::move(object)));
+	}
+	return *this;
+}
+
+//---------------------------------------------------------------
+
 Object& Value::FromObject (void) {
-	if (!IsObject()) {
+	if (IsObject())
+		DPTR(value.objectValue)->Clear();
+	else {
 		Clear();
 		value.type = Type::Object;
+		value.objectValue = DNEW(Object);
 	}
-	return *DPTR(value.objectValue = DNEW(Object));
+	return *DPTR(value.objectValue);
 }
 
 //---------------------------------------------------------------
@@ -148,7 +178,7 @@ double Value::ToNumber (void) const {
 
 const std::string& Value::ToString (void) const {
     DASSERT(value.type == Type::String);
-    return *DPTR(value.stringValue);
+    return String();
 }
 
 //---------------------------------------------------------------
@@ -193,7 +223,7 @@ util_ui64 Value::ToFunctionTag (void) const {
 
 //---------------------------------------------------------------
 
-void Value::InitialiseFrom (const Value& other, bool copy) {
+void Value::InitialiseFrom (const Value& other) {
 
     switch (value.type = other.value.type) {	// mind the assignment
 
@@ -217,15 +247,15 @@ void Value::InitialiseFrom (const Value& other, bool copy) {
             return;
 
 		case Type::String:
-            value.stringValue = copy ? DNEWCLASS(std::string, (*DPTR(other.value.stringValue))) : other.value.stringValue;
+            new (value.stringValue) std::string(other.String());
             return;
 
         case Type::Object:
-            value.objectValue = copy ? DNEWCLASS(Object, (*DPTR(other.value.objectValue))) : other.value.objectValue;
+            value.objectValue = DNEWCLASS(Object, (*DPTR(other.value.objectValue)));
             return;
 
 		case Type::Function:
-            value.functionValue.f = copy ? DNEWCLASS(Function, (*DPTR(other.value.functionValue.f))) : other.value.functionValue.f;
+            value.functionValue.f = DNEWCLASS(Function, (*DPTR(other.value.functionValue.f)));
 			value.functionValue.tag = other.value.functionValue.tag;
             return;
     }
@@ -233,44 +263,17 @@ void Value::InitialiseFrom (const Value& other, bool copy) {
 
 //---------------------------------------------------------------
 
-void Value::Nullify (void) {
+void Value::MoveFrom (Value& other) {
 
-    switch (value.type) {
-
-        case Type::Undefined:
-            return;
-
-        case Type::Number:
-            value.numberValue = 0;
-            break;
-
-        case Type::Boolean:
-            value.booleanValue = false;
-            break;
-
-        case Type::Reference:
-            value.referenceValue = nullptr;
-            break;
-
-        case Type::ConstReference:
-            value.constReferenceValue = nullptr;
-            break;
-
-		case Type::String:
-            value.stringValue = nullptr;
-            break;
-
-        case Type::Object:
-            value.objectValue = nullptr;
-            break;
-
-		case Type::Function:
-            value.functionValue.f = nullptr;
-			value.functionValue.tag = UVALUE_UNTYPED_FUNCTION_TAG_ALWAYS_UNIQUE;
-            break;
-    }
-
-    value.type = Type::Undefined;
+	if (other.IsString()) {
+		new (value.stringValue) std::string(std::move(other.String()));
+		value.type = Type::String;
+		other.Clear();
+	}
+	else {
+		value = other.value;					// the rest are plain values or owned pointers
+		other.value.type = Type::Undefined;
+	}
 }
 
 //---------------------------------------------------------------
@@ -287,7 +290,7 @@ void Value::Clear (void) {
 			break;
 
         case Type::String:
-            DDELETE(value.stringValue);
+            String().~basic_string();
             break;
 
         case Type::Object:
@@ -321,7 +324,7 @@ std::size_t ValueHash::operator()(const Value& value) const {
             return std::hash<util_ui64>{}(reinterpret_cast<util_ui64>(value.value.constReferenceValue));
 
 		case Value::Type::String:
-            return std::hash<std::string>{}(*DPTR(value.value.stringValue));
+            return std::hash<std::string>{}(value.String());
 
         case Value::Type::Object:
             return std::hash<util_ui64>{}(reinterpret_cast<util_ui64>(value.value.objectValue));
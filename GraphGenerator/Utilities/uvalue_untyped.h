@@ -8,6 +8,8 @@
 #include <unordered_map>
 #include <functional>
 #include <string>
+#include <new>
+#include <utility>
 #include <assert.h>
 
 #define UVALUE_UNTYPED_FUNCTION_TAG_ALWAYS_UNIQUE	0XFFFFFFFF
@@ -35,9 +37,12 @@ static_assert(sizeof(uint64_t) <= sizeof(double));
 	}
 
 #define	UOVERLOADED_ASSIGN_VIA_MOVE_CONSTRUCTOR(_class)						\
-	const _class& operator=(_class&& xvalue) {								\
-		udestructor_invocation(this);										\
-		return *new (this) _class(xvalue);									\
+	const _class& operator=(_class&& xvalue) noexcept {						\
+		if (this != &xvalue) {												\
+			udestructor_invocation(this);									\
+			new (this) _class(std::move(xvalue));							\
+		}																	\
+		return *this;														\
 	}
 
 template <typename T> void udestructor_invocation(T* t)
@@ -70,13 +75,15 @@ class UTILLIB_CLASS Value {
 
 	Value (void);
     Value (const Value& other);
-    Value (Value&& other);
+    Value (Value&& other) noexcept;
     ~Value();
 
 	Value (Object& obj)				{ value.type = Type::Undefined; FromObject(obj);			}
+	Value (Object&& obj)			{ value.type = Type::Undefined; FromObject(std::move(obj));	}
 	Value (double num)				{ value.type = Type::Undefined; FromNumber(num);			}
 	Value (util_i64 num)			{ value.type = Type::Undefined; FromNumber((double) num);	}
 	Value (const std::string& s)	{ value.type = Type::Undefined; FromString(s);				}
+	Value (std::string&& s)			{ value.type = Type::Undefined; FromString(std::move(s));	}
 	Value (const char* s)			{ value.type = Type::Undefined; FromString(s);				}
 	Value (bool val)				{ value.type = Type::Undefined; FromBoolean(val);			}
 	Value (void* ref)				{ value.type = Type::Undefined; FromReference(ref);			}
@@ -106,13 +113,15 @@ class UTILLIB_CLASS Value {
 								{ DASSERT(IsFunction()); ToFunction()(); }
 
     Value&					FromNumber (double number);
-	Value&					FromNumber (util_i64 number) { FromNumber((double)number); }
+	Value&					FromNumber (util_i64 number) { return FromNumber((double)number); }
 	Value&					FromString (const std::string& s);
+	Value&					FromString (std::string&& s);
     Value&					FromBoolean (bool boolean);
     Value&					FromReference (void* reference);
     Value&					FromConstReference (const void* reference);
     Value&					FromObject (const Object& object);	// deep copy
-    Object&					FromObject (void);
+    Value&					FromObject (Object&& object);
+    Object&					FromObject (void);					// an empty object
 	void					Undefine (void);
 
 	template <typename Tfunc>
@@ -147,17 +156,23 @@ class UTILLIB_CLASS Value {
 	//---------------------------------------------------------------
 
 	private:
-    void					InitialiseFrom (const Value& other, bool copy);
-    void					Nullify (void);
+    void					InitialiseFrom (const Value& other);
+    void					MoveFrom (Value& other);			// other is left undefined
     void					Clear (void);
 
+	std::string&			String (void)
+								{ return *std::launder(reinterpret_cast<std::string*>(value.stringValue)); }
+	const std::string&		String (void) const
+								{ return *std::launder(reinterpret_cast<const std::string*>(value.stringValue)); }
+
     struct {
 
         Type type;
 
         union {
             double			numberValue;
-            std::string*	stringValue;
+			alignas(std::string) 
+			unsigned char	stringValue[sizeof(std::string)];	// in place: no allocation for short strings
             bool			booleanValue;
             void*			referenceValue;
             const void*		constReferenceValue;